@@ -75,6 +75,18 @@ else
     $STATUS=1
 fi
 
+echo "- Looking for LLVM profile runtime (optional, required by -pgo-gen)"
+PGO_LIB=""
+if [ -x "$(command -v clang)" ]; then
+    PGO_LIB=$(clang --print-file-name=libclang_rt.profile-x86_64.a)
+fi
+if [ -e "$PGO_LIB" ]; then
+    echo "  FOUND - $PGO_LIB"
+else
+    PGO_LIB=""
+    echo "  warning: Cannot find 'libclang_rt.profile-x86_64.a', executables cannot be built with -pgo-gen. You can set LINKER_PGO_LIB manually in etc/bl.conf file."
+fi
+
 RT_O=$LIB_DIR/rt/blrt_x86_64_linux.o
 LINKER_OPT="-e $RT_ENTRY_POINT $RT_O --hash-style=gnu --no-add-needed --build-id --eh-frame-hdr -dynamic-linker $LDLIB -lc -lm"
 
@@ -85,6 +97,9 @@ echo LIB_DIR \"$LIB_DIR/api\" >> $CONFIG_FILE
 echo LINKER_EXEC \"$LINKER_EXEC\" >> $CONFIG_FILE
 echo LINKER_OPT \"$LINKER_OPT\" >> $CONFIG_FILE
 echo LINKER_LIB_PATH \"/usr/lib:/usr/local/lib:/lib64\" >> $CONFIG_FILE
+if [ -n "$PGO_LIB" ]; then
+    echo LINKER_PGO_LIB \"$PGO_LIB\" >> $CONFIG_FILE
+fi
 
 if [ $STATUS -eq 0 ]; then
     CONFIG_FILE=$(realpath $CONFIG_FILE)
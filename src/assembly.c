@@ -105,11 +105,25 @@ init_llvm(Assembly *assembly)
 {
 	/* init LLVM */
 	char *triple    = LLVMGetDefaultTargetTriple();
-	char *cpu       = /*LLVMGetHostCPUName()*/ "";
-	char *features  = /*LLVMGetHostCPUFeatures()*/ "";
+	char *cpu       = NULL;
+	char *features  = NULL;
 	char *error_msg = NULL;
 
+	const char *target_cpu      = builder.options.target_cpu;
+	const char *target_features = builder.options.target_features;
+
+	if (target_cpu && strcmp(target_cpu, "native") == 0) {
+		cpu = LLVMGetHostCPUName();
+		/* Use all features of host CPU if they are not specified explicitly. */
+		if (!target_features) features = LLVMGetHostCPUFeatures();
+	} else {
+		cpu = LLVMCreateMessage(target_cpu ? target_cpu : "");
+	}
+
+	if (!features) features = LLVMCreateMessage(target_features ? target_features : "");
+
 	msg_log("Target: %s", triple);
+	if (cpu[0] != '\0') msg_log("Target CPU: %s", cpu);
 
 	LLVMTargetRef llvm_target = NULL;
 	if (LLVMGetTargetFromTriple(triple, &llvm_target, &error_msg)) {
@@ -133,11 +147,13 @@ init_llvm(Assembly *assembly)
 	LLVMSetModuleDataLayout(llvm_module, llvm_td);
 	LLVMSetTarget(llvm_module, triple);
 
-	assembly->llvm.cnt    = llvm_context;
-	assembly->llvm.module = llvm_module;
-	assembly->llvm.TM     = llvm_tm;
-	assembly->llvm.TD     = llvm_td;
-	assembly->llvm.triple = triple;
+	assembly->llvm.cnt      = llvm_context;
+	assembly->llvm.module   = llvm_module;
+	assembly->llvm.TM       = llvm_tm;
+	assembly->llvm.TD       = llvm_td;
+	assembly->llvm.triple   = triple;
+	assembly->llvm.cpu      = cpu;
+	assembly->llvm.features = features;
 }
 
 static void
@@ -180,6 +196,8 @@ terminate_llvm(Assembly *assembly)
 	LLVMDisposeModule(assembly->llvm.module);
 	LLVMDisposeTargetMachine(assembly->llvm.TM);
 	LLVMDisposeMessage(assembly->llvm.triple);
+	LLVMDisposeMessage(assembly->llvm.cpu);
+	LLVMDisposeMessage(assembly->llvm.features);
 	LLVMDisposeTargetData(assembly->llvm.TD);
 	LLVMContextDispose(assembly->llvm.cnt);
 }
@@ -207,6 +225,8 @@ assembly_new(const char *name)
 	if (!assembly) BL_ABORT("bad alloc");
 	assembly->name = strdup(name);
 	tarray_init(&assembly->units, sizeof(Unit *));
+	tarray_init(&assembly->obj_files, sizeof(char *));
+	tarray_init(&assembly->mem_files, sizeof(s32));
 	thtbl_init(&assembly->unit_cache, 0, EXPECTED_UNIT_COUNT);
 	thtbl_init(&assembly->link_cache, sizeof(Token *), EXPECTED_LINK_COUNT);
 
@@ -251,7 +271,15 @@ assembly_delete(Assembly *assembly)
 	ast_arena_terminate(&assembly->arenas.ast);
 	scope_arenas_terminate(&assembly->arenas.scope);
 
+	char *obj_file;
+	TARRAY_FOREACH(char *, &assembly->obj_files, obj_file) bl_free(obj_file);
+
+	s32 mem_file;
+	TARRAY_FOREACH(s32, &assembly->mem_files, mem_file) mem_file_close(mem_file);
+
 	tarray_terminate(&assembly->units);
+	tarray_terminate(&assembly->obj_files);
+	tarray_terminate(&assembly->mem_files);
 	thtbl_terminate(&assembly->unit_cache);
 	thtbl_terminate(&assembly->link_cache);
 	terminate_dl(assembly);
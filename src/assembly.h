@@ -61,6 +61,8 @@ typedef struct Assembly {
 		LLVMTargetDataRef    TD;         /* LLVM Target data. */
 		LLVMTargetMachineRef TM;         /* LLVM Machine. */
 		char *               triple;     /* LLVM triple. */
+		char *               cpu;        /* LLVM target CPU name. */
+		char *               features;   /* LLVM target CPU features. */
 		LLVMMetadataRef      di_meta;    /* LLVM Compile unit DI meta (optional) */
 		LLVMDIBuilderRef     di_builder; /* LLVM debug information builder */
 	} llvm;
@@ -73,6 +75,8 @@ typedef struct Assembly {
 	} dl;
 
 	TArray     units;      /* array of all units in assembly */
+	TArray     obj_files;  /* object files written by obj_writer (char *) */
+	TArray     mem_files;  /* descriptors of in-memory object files (s32) */
 	THashTable unit_cache; /* cache for loading only unique units */
 	THashTable link_cache; /* all linked externals libraries passed to linker */
 	char *     name;       /* assembly name */
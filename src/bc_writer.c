@@ -32,27 +32,55 @@
 #include "stages.h"
 #include <string.h>
 
-void
-bc_writer_run(Assembly *assembly)
+static char *
+get_export_file(Assembly *assembly, const char *ext)
 {
-	char *export_file = malloc(sizeof(char) * (strlen(assembly->name) + 4));
+	char *export_file = malloc(sizeof(char) * (strlen(assembly->name) + strlen(ext) + 1));
 	if (!export_file) BL_ABORT("bad alloc");
 	strcpy(export_file, assembly->name);
-	strcat(export_file, ".ll");
+	strcat(export_file, ext);
+	return export_file;
+}
 
-	char *str = LLVMPrintModuleToString(assembly->llvm.module);
+/* Textual IR is streamed into the file by LLVM, so whole module is never printed into single
+ * string in memory. */
+static void
+write_ll(Assembly *assembly)
+{
+	char *export_file = get_export_file(assembly, ".ll");
+	char *error_msg   = NULL;
 
-	FILE *f = fopen(export_file, "w");
-	if (f == NULL) {
-		builder_error("Cannot open file %s", export_file);
+	if (LLVMPrintModuleToFile(assembly->llvm.module, export_file, &error_msg)) {
+		builder_error("Cannot write file %s: %s", export_file, error_msg);
+		LLVMDisposeMessage(error_msg);
 		free(export_file);
 		return;
 	}
-	fprintf(f, "%s\n", str);
-	fclose(f);
-	LLVMDisposeMessage(str);
 
 	msg_log("Byte code written into " GREEN("%s"), export_file);
 
 	free(export_file);
 }
+
+static void
+write_bc(Assembly *assembly)
+{
+	char *export_file = get_export_file(assembly, ".bc");
+
+	if (LLVMWriteBitcodeToFile(assembly->llvm.module, export_file) != 0) {
+		builder_error("Cannot write file %s", export_file);
+		free(export_file);
+		return;
+	}
+
+	msg_log("Bitcode written into " GREEN("%s"), export_file);
+
+	free(export_file);
+}
+
+void
+bc_writer_run(Assembly *assembly)
+{
+	if (builder.options.emit_llvm) write_ll(assembly);
+	if (builder.options.emit_bc) write_bc(assembly);
+}
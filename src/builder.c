@@ -133,7 +133,7 @@ compile_assembly(Assembly *assembly)
 	ir_opt_run(assembly);
 	INTERRUPT_ON_ERROR;
 
-	if (builder.options.emit_llvm) {
+	if (builder.options.emit_llvm || builder.options.emit_bc) {
 		bc_writer_run(assembly);
 		INTERRUPT_ON_ERROR;
 	}
@@ -153,6 +153,8 @@ s32
 builder_parse_options(s32 argc, char *argv[])
 {
 #define arg_is(_arg) (strcmp(&argv[optind][1], _arg) == 0)
+#define arg_starts_with(_arg) (strncmp(&argv[optind][1], _arg, strlen(_arg)) == 0)
+#define arg_value(_arg) (&argv[optind][1] + strlen(_arg))
 
 	builder.options.opt_level = OPT_NOT_SPECIFIED;
 	s32 optind;
@@ -167,6 +169,8 @@ builder_parse_options(s32 argc, char *argv[])
 			builder.options.syntax_only = true;
 		} else if (arg_is("emit-llvm")) {
 			builder.options.emit_llvm = true;
+		} else if (arg_is("emit-bc")) {
+			builder.options.emit_bc = true;
 		} else if (arg_is("emit-mir")) {
 			builder.options.emit_mir = true;
 		} else if (arg_is("r") || arg_is("run")) {
@@ -195,6 +199,71 @@ builder_parse_options(s32 argc, char *argv[])
 			builder.options.reg_split = true;
 		} else if (arg_is("reg-split-off")) {
 			builder.options.reg_split = false;
+		} else if (arg_is("vm-frame-slots-on")) {
+			builder.options.vm_frame_slots = true;
+		} else if (arg_is("vm-frame-slots-off")) {
+			builder.options.vm_frame_slots = false;
+		} else if (arg_starts_with("comptime-threads=")) {
+			builder.options.comptime_threads = atoi(arg_value("comptime-threads="));
+			if (builder.options.comptime_threads < 1) {
+				msg_error("invalid count of compile time threads '%s'", &argv[optind][1]);
+				return -1;
+			}
+		} else if (arg_starts_with("vm-max-steps=")) {
+			const char *value = arg_value("vm-max-steps=");
+			char *      end   = NULL;
+			/* strtoull silently wraps negative values, accept only digits. */
+			builder.options.vm_max_steps = strtoull(value, &end, 10);
+			if (*value < '0' || *value > '9' || *end != '\0' ||
+			    builder.options.vm_max_steps == 0) {
+				msg_error("invalid compile time execution step limit '%s'",
+				          &argv[optind][1]);
+				return -1;
+			}
+		} else if (arg_starts_with("vm-timeout=")) {
+			builder.options.vm_timeout = atoi(arg_value("vm-timeout="));
+			if (builder.options.vm_timeout < 0) {
+				msg_error("invalid compile time execution timeout '%s'", &argv[optind][1]);
+				return -1;
+			}
+		} else if (arg_starts_with("target-cpu=")) {
+			builder.options.target_cpu = arg_value("target-cpu=");
+		} else if (arg_starts_with("target-features=")) {
+			builder.options.target_features = arg_value("target-features=");
+		} else if (arg_starts_with("codegen-threads=")) {
+			builder.options.codegen_threads = atoi(arg_value("codegen-threads="));
+			if (builder.options.codegen_threads < 1) {
+				msg_error("invalid count of code generation threads '%s'", &argv[optind][1]);
+				return -1;
+			}
+		} else if (arg_is("pgo-gen")) {
+			builder.options.pgo_gen = true;
+		} else if (arg_starts_with("pgo-use=")) {
+			builder.options.pgo_use = arg_value("pgo-use=");
+			if (!file_exists(builder.options.pgo_use)) {
+				msg_error("profile data file '%s' not found", builder.options.pgo_use);
+				return -1;
+			}
+		} else if (arg_starts_with("obj-cache=")) {
+			builder.options.obj_cache_dir = arg_value("obj-cache=");
+		} else if (arg_starts_with("obj-cache-size=")) {
+			builder.options.obj_cache_size = strtoull(arg_value("obj-cache-size="), NULL, 10);
+		} else if (arg_starts_with("link-bc=")) {
+			const char *file = arg_value("link-bc=");
+			if (!file_exists(file)) {
+				msg_error("bitcode file '%s' not found", file);
+				return -1;
+			}
+			tarray_push(&builder.options.link_bc_files, file);
+		} else if (arg_is("keep-obj")) {
+			builder.options.keep_obj = true;
+		} else if (arg_is("lld")) {
+#if defined(BL_USE_LLD) && defined(BL_PLATFORM_LINUX)
+			builder.options.use_lld = true;
+#else
+			msg_error("in-process LLD linker is not available in this build");
+			return -1;
+#endif
 		} else if (arg_is("opt-none")) {
 			builder.options.opt_level = OPT_NONE;
 		} else if (arg_is("opt-less")) {
@@ -208,9 +277,16 @@ builder_parse_options(s32 argc, char *argv[])
 			return -1;
 		}
 	}
+	if (builder.options.pgo_gen && builder.options.pgo_use) {
+		msg_error("options '-pgo-gen' and '-pgo-use' cannot be used together");
+		return -1;
+	}
+
 	argv += optind;
 	return optind;
 #undef arg_is
+#undef arg_starts_with
+#undef arg_value
 }
 
 void
@@ -230,6 +306,8 @@ builder_init(void)
 	builder.options.reg_split = false;
 #endif
 
+	tarray_init(&builder.options.link_bc_files, sizeof(const char *));
+
 	/* initialize LLVM statics */
 	llvm_init();
 
@@ -240,6 +318,7 @@ void
 builder_terminate(void)
 {
 	vm_terminate(&builder.vm);
+	tarray_terminate(&builder.options.link_bc_files);
 	conf_data_delete(builder.conf);
 	arena_terminate(&builder.str_cache);
 }
@@ -59,6 +59,7 @@ typedef struct BuilderOpions {
 	bool     no_llvm;
 	bool     no_analyze;
 	bool     emit_llvm;
+	bool     emit_bc;
 	bool     emit_mir;
 	bool     load_from_file;
 	bool     syntax_only;
@@ -66,6 +67,21 @@ typedef struct BuilderOpions {
 	bool     force_test_llvm;
 	bool     debug_build;
 	bool     reg_split;
+	bool     vm_frame_slots;
+	s32      comptime_threads;
+	u64      vm_max_steps; /* zero means no limit */
+	s32      vm_timeout;   /* in seconds, zero means no limit */
+
+	const char *target_cpu;      /* optional, 'native' for host CPU */
+	const char *target_features; /* optional */
+	s32         codegen_threads;
+	bool        pgo_gen;
+	const char *pgo_use; /* optional, path to .profdata file */
+	bool        use_lld;
+	bool        keep_obj;
+	const char *obj_cache_dir;  /* optional */
+	u64         obj_cache_size; /* in MB, zero means default */
+	TArray      link_bc_files;  /* bitcode modules linked into assembly (const char *) */
 } BuilderOptions;
 
 typedef struct Builder {
@@ -38,6 +38,14 @@
 #include <mach-o/dyld.h>
 #endif
 
+#ifdef BL_PLATFORM_LINUX
+#include <sys/syscall.h>
+#endif
+
+#ifndef BL_PLATFORM_WIN
+#include <sys/stat.h>
+#endif
+
 #ifdef BL_PLATFORM_WIN
 #include <windows.h>
 #endif
@@ -85,6 +93,16 @@ file_exists(const char *filepath)
 #endif
 }
 
+bool
+create_dir(const char *dirpath)
+{
+#if defined(BL_PLATFORM_WIN)
+	return (bool)CreateDirectoryA(dirpath, NULL);
+#else
+	return mkdir(dirpath, 0755) == 0;
+#endif
+}
+
 const char *
 brealpath(const char *file, char *out, s32 out_len)
 {
@@ -219,6 +237,47 @@ platform_lib_name(const char *name, char *buffer, usize max_len)
 #endif
 }
 
+s32
+mem_file_create(const char *name, char *path, usize path_len)
+{
+#if defined(BL_PLATFORM_LINUX) && defined(SYS_memfd_create)
+	/* Descriptor must be inherited by linker process, so there is no MFD_CLOEXEC. */
+	const s32 fd = (s32)syscall(SYS_memfd_create, name, 0);
+	if (fd == -1) return -1;
+
+	snprintf(path, path_len, "/proc/self/fd/%d", fd);
+	return fd;
+#else
+	return -1;
+#endif
+}
+
+bool
+mem_file_write(s32 fd, const void *data, usize size)
+{
+#ifndef BL_COMPILER_MSVC
+	const u8 *ptr = data;
+	while (size) {
+		const ssize_t written = write(fd, ptr, size);
+		if (written <= 0) return false;
+		ptr += written;
+		size -= (usize)written;
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+void
+mem_file_close(s32 fd)
+{
+#ifndef BL_COMPILER_MSVC
+	close(fd);
+#endif
+}
+
 TArray *
 create_arr(Assembly *assembly, usize size)
 {
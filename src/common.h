@@ -76,6 +76,9 @@ id_init(ID *id, const char *str);
 bool
 file_exists(const char *filepath);
 
+bool
+create_dir(const char *dirpath);
+
 const char *
 brealpath(const char *file, char *out, s32 out_len);
 
@@ -109,6 +112,20 @@ count_bits(u64 n);
 void
 platform_lib_name(const char *name, char *buffer, usize max_len);
 
+/*
+ * Create anonymous file living only in memory (Linux only). Path to the file usable also by
+ * child processes is written into 'path'. Returns file descriptor or -1 when in-memory files
+ * are not supported.
+ */
+s32
+mem_file_create(const char *name, char *path, usize path_len);
+
+bool
+mem_file_write(s32 fd, const void *data, usize size);
+
+void
+mem_file_close(s32 fd);
+
 /*
  * Creates BArray inside Assembly arena.
  * Note: no free is needed.
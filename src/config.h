@@ -0,0 +1,110 @@
+//************************************************************************************************
+// bl
+//
+// File:   config.h
+// Author: Martin Dorazil
+// Date:   3/12/18
+//
+// Copyright 2018 Martin Dorazil
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//************************************************************************************************
+
+#ifndef BL_CONFIG_H
+#define BL_CONFIG_H
+
+/*
+ * Values set automatically during build by cmake.
+ */
+#define BL_VERSION "0.5.1"
+#define BL_VERSION_MAJOR 0
+#define BL_VERSION_MINOR 5
+#define BL_VERSION_PATCH 1
+
+#define BL_CONF_FILE "etc/bl.conf"
+
+#ifdef _WIN32
+#define BL_PLATFORM_WIN
+#define BL_NO_COLOR
+#define OS_PRELOAD_FILE "os/windows.bl"
+#elif __APPLE__
+//#define BL_NO_COLOR
+#define BL_PLATFORM_MACOS
+#define OS_PRELOAD_FILE "os/macos.bl"
+#elif __linux__
+#define BL_PLATFORM_LINUX
+#define OS_PRELOAD_FILE "os/linux.bl"
+#elif __CYGWIN__
+#define BL_PLATFORM_WIN
+#else
+#error "Unknown platform"
+#endif
+
+#ifdef __clang__
+#define BL_COMPILER_CLANG
+#elif __GNUC__
+#define BL_COMPILER_GNUC
+#elif __MINGW32__
+#define BL_COMPILER_GNUC
+#elif _MSC_VER
+#define BL_COMPILER_MSVC
+#endif
+
+#ifdef BL_COMPILER_MSVC
+#define NOMINMAX /* WTF??? */
+#endif
+
+#define ENV_PATH "PATH"
+#ifndef PATH_MAX
+#define PATH_MAX 1024
+#endif
+
+#ifdef BL_PLATFORM_WIN
+#define PATH_SEPARATOR "\\"
+#define PATH_SEPARATORC '\\'
+#define ENVPATH_SEPARATOR ';'
+#define CONF_VC_VARS_ALL_KEY "VC_VARS_ALL"
+#define MSVC_CRT "msvcrt"
+#else
+#define PATH_SEPARATOR "/"
+#define PATH_SEPARATORC '/'
+#define ENVPATH_SEPARATOR ':'
+#endif
+
+#if BL_DEBUG
+#define ASSERT_ON_CMP_ERROR 0
+#else
+#define ASSERT_ON_CMP_ERROR 0
+#endif
+
+#define VM_STACK_SIZE 2097152          // 2MB
+#define VM_COMPTIME_CACHE_SIZE 1048576 // 1MB
+#define BL_CONFIGURE_SH "blc_configure.sh"
+
+#define CONF_LINKER_EXEC_KEY "LINKER_EXEC"
+#define CONF_LINKER_OPT_KEY "LINKER_OPT"
+#define CONF_LINKER_LIB_PATH_KEY "LINKER_LIB_PATH"
+#define CONF_LIB_DIR_KEY "LIB_DIR"
+#define CONF_LINKER_PGO_LIB_KEY "LINKER_PGO_LIB" /* optional */
+
+extern char *ENV_LIB_DIR;
+extern char *ENV_EXEC_DIR;
+extern char *ENV_CONF_FILEPATH;
+
+#endif // BL_CONFIG_H
@@ -109,6 +109,8 @@ typedef enum {
 	ERR_NUM_LIT_OVERFLOW        = 73,
 	ERR_INVALID_SWITCH_CASE     = 74,
 	ERR_DUPLICIT_SWITCH_CASE    = 75,
+	ERR_UNKNOWN_INTRINSIC       = 76,
+	ERR_COMPTIME_LIMIT          = 77,
 } Error;
 
 #endif // BL_ERROR_H
@@ -59,6 +59,10 @@ typedef struct {
 	/* Constants */
 	LLVMValueRef llvm_const_i64;
 
+	/* Function attributes set by target options (optional). */
+	LLVMAttributeRef llvm_attr_target_cpu;
+	LLVMAttributeRef llvm_attr_target_features;
+
 	THashTable gstring_cache;
 
 	struct BuiltinTypes *builtin_types;
@@ -206,6 +210,12 @@ emit_instr_load(Context *cnt, MirInstrLoad *load);
 static void
 emit_instr_call(Context *cnt, MirInstrCall *call);
 
+static void
+emit_intrinsic_call(Context *cnt, MirInstrCall *call, MirFn *fn);
+
+static void
+emit_intrinsic_atomic_call(Context *cnt, MirInstrCall *call, MirFn *fn);
+
 static void
 emit_instr_elem_ptr(Context *cnt, MirInstrElemPtr *elem_ptr);
 
@@ -276,6 +286,21 @@ emit_fn_proto(Context *cnt, MirFn *fn)
 		    fn->llvm_value, (unsigned)LLVMAttributeFunctionIndex, llvm_attr);
 	}
 
+	/* External functions are compiled elsewhere. */
+	if (!IS_FLAG(fn->flags, FLAG_EXTERN)) {
+		if (cnt->llvm_attr_target_cpu) {
+			LLVMAddAttributeAtIndex(fn->llvm_value,
+			                        (unsigned)LLVMAttributeFunctionIndex,
+			                        cnt->llvm_attr_target_cpu);
+		}
+
+		if (cnt->llvm_attr_target_features) {
+			LLVMAddAttributeAtIndex(fn->llvm_value,
+			                        (unsigned)LLVMAttributeFunctionIndex,
+			                        cnt->llvm_attr_target_features);
+		}
+	}
+
 	return fn->llvm_value;
 }
 
@@ -1714,6 +1739,12 @@ emit_instr_call(Context *cnt, MirInstrCall *call)
 
 	MirFn *callee_fn =
 	    mir_is_comptime(callee) ? MIR_CEV_READ_AS(MirFn *, &callee->value) : NULL;
+
+	if (callee_fn && IS_FLAG(callee_fn->flags, FLAG_INTRINSIC)) {
+		emit_intrinsic_call(cnt, call, callee_fn);
+		return;
+	}
+
 	LLVMValueRef llvm_called_fn =
 	    callee->llvm_value ? callee->llvm_value : emit_fn_proto(cnt, callee_fn);
 
@@ -1879,6 +1910,8 @@ emit_instr_decl_var(Context *cnt, MirInstrDeclVar *decl)
 	if (var->value.type->kind == MIR_TYPE_TYPE) return;
 
 	if (var->is_global) {
+		/* unused global */
+		if (!var->emit_llvm) return;
 		emit_global_var_proto(cnt, var);
 
 		if (cnt->debug_mode) {
@@ -2226,12 +2259,145 @@ emit_allocas(Context *cnt, MirFn *fn)
 	}
 }
 
+void
+emit_intrinsic_call(Context *cnt, MirInstrCall *call, MirFn *fn)
+{
+	if (fn->intrinsic >= MIR_BUILTIN_ID_INTRINSIC_ATOMIC_LOAD) {
+		emit_intrinsic_atomic_call(cnt, call, fn);
+		return;
+	}
+
+	TSmallArray_InstrPtr *args = call->args;
+	BL_ASSERT(args && args->size == 3 && "Invalid count of intrinsic arguments!");
+
+	LLVMTypeRef  llvm_i8_ptr_type = LLVMPointerType(LLVMInt8TypeInContext(cnt->llvm_cnt), 0);
+	LLVMTypeRef  llvm_size_type   = args->data[2]->value.type->llvm_type;
+	LLVMValueRef llvm_is_volatile = LLVMConstInt(LLVMInt1TypeInContext(cnt->llvm_cnt), 0, false);
+	const char * intrinsic_name   = NULL;
+
+	TSmallArray_LLVMType llvm_types;
+	tsa_init(&llvm_types);
+
+	switch (fn->intrinsic) {
+	case MIR_BUILTIN_ID_INTRINSIC_MEMCPY:
+		/* void @llvm.memcpy.p0i8.p0i8.i64(i8*, i8*, i64, i1) */
+		intrinsic_name = "llvm.memcpy";
+		tsa_push_LLVMType(&llvm_types, llvm_i8_ptr_type);
+		tsa_push_LLVMType(&llvm_types, llvm_i8_ptr_type);
+		tsa_push_LLVMType(&llvm_types, llvm_size_type);
+		break;
+
+	case MIR_BUILTIN_ID_INTRINSIC_MEMSET:
+		/* void @llvm.memset.p0i8.i64(i8*, i8, i64, i1) */
+		intrinsic_name = "llvm.memset";
+		tsa_push_LLVMType(&llvm_types, llvm_i8_ptr_type);
+		tsa_push_LLVMType(&llvm_types, llvm_size_type);
+		break;
+
+	default:
+		BL_ABORT("Unknown intrinsic '%s'.", fn->linkage_name);
+	}
+
+	const u32 llvm_intrinsic_id = llvm_lookup_intrinsic_id(intrinsic_name);
+	BL_ASSERT(llvm_intrinsic_id && "Intrinsic not found in LLVM!");
+
+	LLVMValueRef llvm_fn = llvm_get_intrinsic_decl(
+	    cnt->llvm_module, llvm_intrinsic_id, llvm_types.data, llvm_types.size);
+
+	LLVMValueRef llvm_args[] = {
+	    LLVMBuildBitCast(cnt->llvm_builder, args->data[0]->llvm_value, llvm_i8_ptr_type, ""),
+	    args->data[1]->llvm_value,
+	    args->data[2]->llvm_value,
+	    llvm_is_volatile,
+	};
+
+	if (fn->intrinsic == MIR_BUILTIN_ID_INTRINSIC_MEMCPY) {
+		llvm_args[1] =
+		    LLVMBuildBitCast(cnt->llvm_builder, llvm_args[1], llvm_i8_ptr_type, "");
+	}
+
+	if (cnt->debug_mode) emit_DI_instr_loc(cnt, &call->base);
+
+	call->base.llvm_value = LLVMBuildCall(cnt->llvm_builder, llvm_fn, llvm_args, 4, "");
+	tsa_terminate(&llvm_types);
+}
+
+void
+emit_intrinsic_atomic_call(Context *cnt, MirInstrCall *call, MirFn *fn)
+{
+	/* All atomic operations are sequentially consistent. */
+	const LLVMAtomicOrdering ordering = LLVMAtomicOrderingSequentiallyConsistent;
+	TSmallArray_InstrPtr *   args     = call->args;
+
+	if (cnt->debug_mode) emit_DI_instr_loc(cnt, &call->base);
+
+	if (fn->intrinsic == MIR_BUILTIN_ID_INTRINSIC_ATOMIC_FENCE) {
+		call->base.llvm_value = LLVMBuildFence(cnt->llvm_builder, ordering, false, "");
+		return;
+	}
+
+	BL_ASSERT(args && args->size >= 1 && "Invalid count of intrinsic arguments!");
+	LLVMValueRef   llvm_ptr  = args->data[0]->llvm_value;
+	const unsigned alignment = (unsigned)mir_deref_type(args->data[0]->value.type)->alignment;
+
+	switch (fn->intrinsic) {
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_LOAD:
+		call->base.llvm_value = LLVMBuildLoad(cnt->llvm_builder, llvm_ptr, "");
+		LLVMSetOrdering(call->base.llvm_value, ordering);
+		LLVMSetAlignment(call->base.llvm_value, alignment);
+		break;
+
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_STORE:
+		call->base.llvm_value =
+		    LLVMBuildStore(cnt->llvm_builder, args->data[1]->llvm_value, llvm_ptr);
+		LLVMSetOrdering(call->base.llvm_value, ordering);
+		LLVMSetAlignment(call->base.llvm_value, alignment);
+		break;
+
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_ADD:
+		call->base.llvm_value = LLVMBuildAtomicRMW(cnt->llvm_builder,
+		                                           LLVMAtomicRMWBinOpAdd,
+		                                           llvm_ptr,
+		                                           args->data[1]->llvm_value,
+		                                           ordering,
+		                                           false);
+		break;
+
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_XCHG:
+		call->base.llvm_value = LLVMBuildAtomicRMW(cnt->llvm_builder,
+		                                           LLVMAtomicRMWBinOpXchg,
+		                                           llvm_ptr,
+		                                           args->data[1]->llvm_value,
+		                                           ordering,
+		                                           false);
+		break;
+
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_CMPXCHG: {
+		/* cmpxchg returns { value, success } pair, only previous value is used. */
+		LLVMValueRef llvm_pair = LLVMBuildAtomicCmpXchg(cnt->llvm_builder,
+		                                                llvm_ptr,
+		                                                args->data[1]->llvm_value,
+		                                                args->data[2]->llvm_value,
+		                                                ordering,
+		                                                ordering,
+		                                                false);
+		call->base.llvm_value  = LLVMBuildExtractValue(cnt->llvm_builder, llvm_pair, 0, "");
+		break;
+	}
+
+	default:
+		BL_ABORT("Unknown intrinsic '%s'.", fn->linkage_name);
+	}
+}
+
 void
 emit_instr_fn_proto(Context *cnt, MirInstrFnProto *fn_proto)
 {
 	MirFn *fn = MIR_CEV_READ_AS(MirFn *, &fn_proto->base.value);
 	/* unused function */
 	if (!fn->emit_llvm) return;
+	/* intrinsics are generated directly on call side */
+	if (IS_FLAG(fn->flags, FLAG_INTRINSIC)) return;
 	emit_fn_proto(cnt, fn);
 
 	if (IS_NOT_FLAG(fn->flags, FLAG_EXTERN)) {
@@ -2374,6 +2540,20 @@ ir_run(Assembly *assembly)
 	cnt.debug_mode      = builder.options.debug_build;
 	thtbl_init(&cnt.gstring_cache, sizeof(LLVMValueRef), 1024);
 
+	/* Target CPU and features are set also for every function, so they are kept in bitcode
+	 * and cannot be lost by later optimization or linking. */
+	const char *cpu      = assembly->llvm.cpu;
+	const char *features = assembly->llvm.features;
+	if (cpu[0] != '\0') {
+		cnt.llvm_attr_target_cpu = LLVMCreateStringAttribute(
+		    cnt.llvm_cnt, "target-cpu", 10, cpu, (unsigned)strlen(cpu));
+	}
+
+	if (features[0] != '\0') {
+		cnt.llvm_attr_target_features = LLVMCreateStringAttribute(
+		    cnt.llvm_cnt, "target-features", 15, features, (unsigned)strlen(features));
+	}
+
 	MirInstr *ginstr;
 	TARRAY_FOREACH(MirInstr *, &assembly->MIR.global_instrs, ginstr)
 	{
@@ -32,19 +32,115 @@
 #include "stages.h"
 #include "llvm_api.h"
 
+/* Inliner thresholds for -opt-less and higher levels (same as clang uses for -O1/-O2 and -O3). */
+#define INLINE_THRESHOLD_DEFAULT 225
+#define INLINE_THRESHOLD_AGGRESSIVE 275
+
+/* Raw profile written by instrumented executable (can be overridden by LLVM_PROFILE_FILE
+ * environment variable at runtime). */
+#define PGO_GEN_FILE "default.profraw"
+
+static void
+run_fn_passes(LLVMPassManagerBuilderRef llvm_pm_builder,
+              LLVMTargetMachineRef      llvm_tm,
+              LLVMModuleRef             llvm_module)
+{
+	LLVMPassManagerRef llvm_fpm = LLVMCreateFunctionPassManagerForModule(llvm_module);
+	LLVMAddAnalysisPasses(llvm_tm, llvm_fpm);
+	LLVMPassManagerBuilderPopulateFunctionPassManager(llvm_pm_builder, llvm_fpm);
+
+	LLVMInitializeFunctionPassManager(llvm_fpm);
+	LLVMValueRef llvm_fn = LLVMGetFirstFunction(llvm_module);
+	while (llvm_fn) {
+		if (!LLVMIsDeclaration(llvm_fn)) LLVMRunFunctionPassManager(llvm_fpm, llvm_fn);
+		llvm_fn = LLVMGetNextFunction(llvm_fn);
+	}
+
+	LLVMFinalizeFunctionPassManager(llvm_fpm);
+	LLVMDisposePassManager(llvm_fpm);
+}
+
+/* Functions from other assemblies or C libraries compiled into bitcode are imported into the
+ * module, so they can be inlined and optimized together with the rest of the program. */
+static void
+link_bitcode(Assembly *assembly)
+{
+	const char *filepath;
+	TARRAY_FOREACH(const char *, &builder.options.link_bc_files, filepath)
+	{
+		LLVMMemoryBufferRef llvm_buf    = NULL;
+		LLVMModuleRef       llvm_module = NULL;
+		char *              error_msg   = NULL;
+
+		if (LLVMCreateMemoryBufferWithContentsOfFile(filepath, &llvm_buf, &error_msg)) {
+			builder_error("Cannot read bitcode file %s: %s", filepath, error_msg);
+			LLVMDisposeMessage(error_msg);
+			continue;
+		}
+
+		const LLVMBool failed =
+		    LLVMParseBitcodeInContext2(assembly->llvm.cnt, llvm_buf, &llvm_module);
+		LLVMDisposeMemoryBuffer(llvm_buf);
+		if (failed) {
+			builder_error("Cannot parse bitcode file %s", filepath);
+			continue;
+		}
+
+		/* Source module is consumed by linker. */
+		if (!llvm_link_module_needed(assembly->llvm.module, llvm_module)) {
+			builder_error("Cannot link bitcode file %s", filepath);
+		}
+	}
+}
+
 void
 ir_opt_run(Assembly *assembly)
 {
 	LLVMModuleRef        llvm_module = assembly->llvm.module;
 	LLVMTargetMachineRef llvm_tm     = assembly->llvm.TM;
+	const OptLevel       opt_level   = builder.options.opt_level;
+
+	link_bitcode(assembly);
+	if (builder.errorc) return;
 
 	LLVMPassManagerBuilderRef llvm_pm_builder = LLVMPassManagerBuilderCreate();
-	LLVMPassManagerBuilderSetOptLevel(llvm_pm_builder, builder.options.opt_level);
+	LLVMPassManagerBuilderSetOptLevel(llvm_pm_builder, (unsigned)opt_level);
+
+	const bool pgo = builder.options.pgo_gen || builder.options.pgo_use;
+	if (pgo) {
+		llvm_pass_manager_builder_set_pgo(llvm_pm_builder,
+		                                  builder.options.pgo_gen ? PGO_GEN_FILE : NULL,
+		                                  builder.options.pgo_use);
+	}
 
 	LLVMPassManagerRef llvm_pm = LLVMCreatePassManager();
 	LLVMAddAnalysisPasses(llvm_tm, llvm_pm);
-	LLVMPassManagerBuilderPopulateModulePassManager(llvm_pm_builder, llvm_pm);
-	LLVMPassManagerBuilderPopulateLTOPassManager(llvm_pm_builder, llvm_pm, true, true);
+
+	if (opt_level == OPT_NONE) {
+		/* Functions marked as #inline must be inlined even without optimizations. */
+		LLVMAddAlwaysInlinerPass(llvm_pm);
+
+		/* Pass manager builder adds only instrumentation or profile passes here. */
+		if (pgo) LLVMPassManagerBuilderPopulateModulePassManager(llvm_pm_builder, llvm_pm);
+	} else {
+		/* Inliner respects also alwaysinline and noinline attributes set by #inline and
+		 * #no_inline. */
+		const unsigned threshold = opt_level == OPT_AGGRESSIVE ? INLINE_THRESHOLD_AGGRESSIVE
+		                                                       : INLINE_THRESHOLD_DEFAULT;
+		LLVMPassManagerBuilderUseInlinerWithThreshold(llvm_pm_builder, threshold);
+
+		const bool vectorize = opt_level >= OPT_DEFAULT;
+		llvm_pass_manager_builder_set_vectorize(llvm_pm_builder, vectorize, vectorize);
+
+		run_fn_passes(llvm_pm_builder, llvm_tm, llvm_module);
+		LLVMPassManagerBuilderPopulateModulePassManager(llvm_pm_builder, llvm_pm);
+
+		/* Whole program is compiled as single module, so we can use also link time
+		 * optimizations, but they are worth it only on higher levels. */
+		if (opt_level >= OPT_DEFAULT) {
+			LLVMPassManagerBuilderPopulateLTOPassManager(llvm_pm_builder, llvm_pm, true, true);
+		}
+	}
 
 	LLVMRunPassManager(llvm_pm, llvm_module);
 
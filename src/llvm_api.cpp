@@ -29,12 +29,35 @@
 #include "llvm_api.h"
 #include <cmath>
 #include <llvm/ADT/StringSwitch.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/Config/llvm-config.h>
 #include <llvm/IR/Attributes.h>
+#include <llvm/IR/Constants.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Module.h>
 #include <llvm/IR/Type.h>
-#include <llvm/IR/Constants.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#if LLVM_VERSION_MAJOR >= 14
+#include <llvm/MC/TargetRegistry.h>
+#else
+#include <llvm/Support/TargetRegistry.h>
+#endif
+#include <llvm/Linker/Linker.h>
+#include <llvm/Transforms/IPO/Internalize.h>
+#include <llvm/Transforms/IPO/PassManagerBuilder.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
+#ifdef BL_USE_LLD
+#include <lld/Common/Driver.h>
+#endif
+#include <string>
+#include <thread>
+#include <vector>
 
 #define CAST(T) reinterpret_cast<T>
 
@@ -128,3 +151,161 @@ llvm_const_string_in_context(LLVMContextRef context_ref,
         ArrayRef<Constant*> V(chars);
         return CAST(LLVMValueRef)(ConstantArray::get(ArrayType::get(CAST(Type *)(t), len), V));
 }
+
+void
+llvm_pass_manager_builder_set_vectorize(LLVMPassManagerBuilderRef pmb_ref, bool loop, bool slp)
+{
+	PassManagerBuilder *pmb = CAST(PassManagerBuilder *)(pmb_ref);
+	pmb->LoopVectorize      = loop;
+	pmb->SLPVectorize       = slp;
+}
+
+void
+llvm_pass_manager_builder_set_pgo(LLVMPassManagerBuilderRef pmb_ref,
+                                  const char *              gen_file,
+                                  const char *              use_file)
+{
+	PassManagerBuilder *pmb = CAST(PassManagerBuilder *)(pmb_ref);
+	pmb->EnablePGOInstrGen  = gen_file != NULL;
+	pmb->PGOInstrGen        = gen_file ? gen_file : "";
+	pmb->PGOInstrUse        = use_file ? use_file : "";
+}
+
+static TargetMachine *
+llvm_clone_target_machine(TargetMachine *tm)
+{
+	return tm->getTarget().createTargetMachine(tm->getTargetTriple().str(),
+	                                           tm->getTargetCPU(),
+	                                           tm->getTargetFeatureString(),
+	                                           tm->Options,
+	                                           tm->getRelocationModel(),
+	                                           tm->getCodeModel(),
+	                                           tm->getOptLevel());
+}
+
+static void
+llvm_codegen_partition(TargetMachine *tm,
+                       StringRef      bitcode,
+                       const char *   filename,
+                       std::string &  error)
+{
+	LLVMContext context;
+	auto        module = parseBitcodeFile(MemoryBufferRef(bitcode, filename), context);
+	if (!module) {
+		error = toString(module.takeError());
+		return;
+	}
+
+	std::error_code ec;
+	raw_fd_ostream  os(filename, ec, sys::fs::OF_None);
+	if (ec) {
+		error = ec.message();
+		return;
+	}
+
+#if LLVM_VERSION_MAJOR >= 10
+	const auto file_type = CGFT_ObjectFile;
+#else
+	const auto file_type = TargetMachine::CGFT_ObjectFile;
+#endif
+
+	legacy::PassManager pm;
+	if (tm->addPassesToEmitFile(pm, os, nullptr, file_type)) {
+		error = "target machine cannot emit object file";
+		return;
+	}
+
+	pm.run(**module);
+}
+
+bool
+llvm_split_codegen(LLVMModuleRef        module_ref,
+                   LLVMTargetMachineRef tm_ref,
+                   const char **        filenames,
+                   u32                  partc,
+                   char **              error_msg)
+{
+	TargetMachine *tm = CAST(TargetMachine *)(tm_ref);
+
+	/* Partitions are moved into separate contexts as bitcode. */
+	std::vector<SmallString<0>> bitcodes;
+	auto on_partition = [&](std::unique_ptr<Module> part) {
+		SmallString<0>      bitcode;
+		raw_svector_ostream os(bitcode);
+		WriteBitcodeToFile(*part, os);
+		bitcodes.push_back(std::move(bitcode));
+	};
+
+	/* Splitting changes linkage of local symbols, so we split a copy. */
+	std::unique_ptr<Module> copy = CloneModule(*CAST(Module *)(module_ref));
+#if LLVM_VERSION_MAJOR >= 13
+	SplitModule(*copy, partc, on_partition);
+#else
+	SplitModule(std::move(copy), partc, on_partition);
+#endif
+	assert(bitcodes.size() == partc && "Invalid count of module partitions!");
+
+	/* Target machines are not thread safe, every thread uses its own one. */
+	std::vector<std::unique_ptr<TargetMachine>> tms;
+	std::vector<std::string>                    errors(partc);
+	std::vector<std::thread>                    threads;
+	for (u32 i = 0; i < partc; ++i) {
+		tms.emplace_back(llvm_clone_target_machine(tm));
+	}
+
+	for (u32 i = 0; i < partc; ++i) {
+		threads.emplace_back([&, i]() {
+			llvm_codegen_partition(tms[i].get(), bitcodes[i], filenames[i], errors[i]);
+		});
+	}
+
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	for (u32 i = 0; i < partc; ++i) {
+		if (errors[i].empty()) continue;
+		*error_msg = LLVMCreateMessage(errors[i].c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool
+llvm_link_module_needed(LLVMModuleRef dest_ref, LLVMModuleRef src_ref)
+{
+	std::unique_ptr<Module> src(CAST(Module *)(src_ref));
+	Module *                dest = CAST(Module *)(dest_ref);
+
+	auto internalize = [](Module &m, const StringSet<> &imported) {
+		internalizeModule(m, [&imported](const GlobalValue &gv) {
+			return !gv.hasName() || imported.count(gv.getName()) == 0;
+		});
+	};
+
+	/* Linker returns true on error. */
+	return !Linker::linkModules(*dest, std::move(src), Linker::Flags::LinkOnlyNeeded, internalize);
+}
+
+#ifdef BL_USE_LLD
+bool
+llvm_lld_link(const char **argv, s32 argc, char **error_msg)
+{
+	std::string                  out;
+	raw_string_ostream           out_stream(out);
+	const ArrayRef<const char *> args(argv, (size_t)argc);
+
+	/* LLD must not exit the process on error when used as library. */
+#if LLVM_VERSION_MAJOR >= 14
+	const bool ok = lld::elf::link(args, out_stream, out_stream, false, false);
+#elif LLVM_VERSION_MAJOR >= 10
+	const bool ok = lld::elf::link(args, false, out_stream, out_stream);
+#else
+	const bool ok = lld::elf::link(args, false, out_stream);
+#endif
+
+	if (!ok) *error_msg = LLVMCreateMessage(out_stream.str().c_str());
+	return ok;
+}
+#endif
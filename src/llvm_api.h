@@ -30,11 +30,13 @@
 #define BL_LLVM_API_H
 
 #include <llvm-c/Analysis.h>
+#include <llvm-c/BitReader.h>
 #include <llvm-c/BitWriter.h>
 #include <llvm-c/Core.h>
 #include <llvm-c/ExecutionEngine.h>
 #include <llvm-c/Linker.h>
 #include <llvm-c/TargetMachine.h>
+#include <llvm-c/Transforms/IPO.h>
 #include <llvm-c/Transforms/PassManagerBuilder.h>
 #include <llvm-c/Transforms/Vectorize.h>
 #include <llvm-c/Types.h>
@@ -86,6 +88,44 @@ llvm_get_intrinsic_decl(LLVMModuleRef mod_ref,
                         LLVMTypeRef * param_types_ref,
                         usize         param_types_count);
 
+/* Enable or disable loop and SLP vectorizer passes added by pass manager builder (not available
+ * in C API). */
+void
+llvm_pass_manager_builder_set_vectorize(LLVMPassManagerBuilderRef pmb_ref,
+                                        bool                      loop,
+                                        bool                      slp);
+
+/* Setup profile guided optimization passes added by pass manager builder (not available in C
+ * API). Pass 'gen_file' to instrument code to write profile into this file, or 'use_file' to
+ * apply collected profile data; unused file must be NULL. */
+void
+llvm_pass_manager_builder_set_pgo(LLVMPassManagerBuilderRef pmb_ref,
+                                  const char *              gen_file,
+                                  const char *              use_file);
+
+/* Split module into 'partc' partitions by functions and emit object file for each partition in
+ * parallel. Every partition is compiled in its own context by its own copy of passed target
+ * machine, source module is not changed. Error message must be disposed by LLVMDisposeMessage. */
+bool
+llvm_split_codegen(LLVMModuleRef        module_ref,
+                   LLVMTargetMachineRef tm_ref,
+                   const char **        filenames,
+                   u32                  partc,
+                   char **              error_msg);
+
+/* Link definitions from 'src_ref' module needed by 'dest_ref' module (declared but not defined
+ * there) including their dependencies. Imported symbols are internalized, so they can be freely
+ * inlined and removed by optimizer. Source module is destroyed. */
+bool
+llvm_link_module_needed(LLVMModuleRef dest_ref, LLVMModuleRef src_ref);
+
+#ifdef BL_USE_LLD
+/* Link ELF executable in-process by LLD; 'argv' contains the same arguments as for system 'ld'
+ * command (including program name). Error message must be disposed by LLVMDisposeMessage. */
+bool
+llvm_lld_link(const char **argv, s32 argc, char **error_msg);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -47,6 +47,7 @@
 #define IMPL_COMPOUND_TMP ".compound"
 #define IMPL_RTTI_ENTRY ".rtti"
 #define IMPL_RET_TMP ".ret"
+#define IMPL_PRINT_STREAM_TMP ".print.stream"
 #define NO_REF_COUNTING -1
 #define VERBOSE_ANALYZE false
 
@@ -78,6 +79,7 @@ TSMALL_ARRAY_TYPE(String, const char *, 64);
 
 typedef struct {
 	VM *      vm;
+	VMPool *  vm_pool; /* Optional */
 	Assembly *assembly;
 	TArray    test_cases;
 	TString   tmp_sh;
@@ -113,6 +115,16 @@ typedef struct {
 		LLVMDIBuilderRef llvm_di_builder;
 	} analyze;
 
+	/* Reachability of functions and globals used at runtime */
+	struct {
+		/* Functions and global variables which can be eliminated mapped to optional
+		 * initializer block. */
+		THashTable candidates;
+
+		/* Blocks to be scanned for references. */
+		TArray queue;
+	} reach;
+
 	/* Builtins */
 	struct BuiltinTypes *builtin_types;
 } Context;
@@ -152,6 +164,13 @@ typedef struct {
 	AnalyzeStageFn stages[];
 } AnalyzeSlotConfig;
 
+/* Stream used by print call lowered in analyze_print_specialization. */
+typedef struct {
+	MirInstrDeclRef *origin;      /* reference to the original print function */
+	MirInstr *       stream_decl; /* implicit local stream of bprint (optional) */
+	MirBuiltinIdKind stream_id;   /* global stream of print and eprint */
+} PrintLowering;
+
 /* Ids of builtin symbols, hash is calculated inside init_builtins function
  * later. */
 static ID builtin_ids[_MIR_BUILTIN_ID_COUNT] = {
@@ -194,6 +213,19 @@ lookup_builtin_type(Context *cnt, MirBuiltinIdKind kind);
 static MirFn *
 lookup_builtin_fn(Context *cnt, MirBuiltinIdKind kind);
 
+static MirBuiltinIdKind
+lookup_intrinsic(ID *id);
+
+/* Return integer type pointed by ptr_type or NULL, atomic intrinsics operate on integers only. */
+static MirType *
+atomic_value_type(MirType *ptr_type);
+
+/* Check whether signature of intrinsic declaration matches implementation provided by the
+ * interpreter and the LLVM backend, expected is set to signature description used in error
+ * message. */
+static bool
+is_intrinsic_signature_valid(MirFn *fn, const char **expected);
+
 /* HACK: Better way to do this will be enable compiler to have default preload file; we need to
  * make lexing, parsing, MIR generation and analyze of this file first and then process rest of the
  * source base. Then it will be guaranteed that all desired builtins are ready to use. */
@@ -555,6 +587,9 @@ append_instr_const_double(Context *cnt, Ast *node, double val);
 static MirInstr *
 append_instr_const_bool(Context *cnt, Ast *node, bool val);
 
+static MirInstr *
+create_instr_const_string(Context *cnt, Ast *node, const char *str);
+
 static MirInstr *
 append_instr_const_string(Context *cnt, Ast *node, const char *str);
 
@@ -926,6 +961,26 @@ analyze_instr_const(Context *cnt, MirInstrConst *cnst);
 static AnalyzeResult
 analyze_instr_call(Context *cnt, MirInstrCall *call);
 
+/* Lower call of std print, eprint or bprint with literal format string into sequence of direct
+ * calls of type specific writers. Call is left untouched when it cannot be lowered. */
+static AnalyzeResult
+analyze_print_specialization(Context *cnt, MirInstrCall *call);
+
+/* Insert pointer to the stream used by lowered print call. */
+static MirInstr *
+insert_print_stream_ref(Context *cnt, MirInstr *before, PrintLowering *pl);
+
+static MirInstr *
+insert_print_hook_call(Context *        cnt,
+                       MirInstr *       before,
+                       PrintLowering *  pl,
+                       MirBuiltinIdKind kind,
+                       MirInstr *       value);
+
+/* Declare implicit local stream used by lowered bprint call. */
+static MirInstr *
+insert_print_buffer_stream(Context *cnt, MirInstr *before);
+
 static AnalyzeResult
 analyze_instr_cast(Context *cnt, MirInstrCast *cast, bool analyze_op_only);
 
@@ -947,6 +1002,24 @@ analyze(Context *cnt);
 static void
 analyze_report_unresolved(Context *cnt);
 
+/***********/
+/*  REACH  */
+/***********/
+static bool
+reach_is_root(Context *cnt, MirFn *fn);
+
+static void
+reach_fn(Context *cnt, MirFn *fn);
+
+static void
+reach_var(Context *cnt, MirVar *var);
+
+static void
+reach_block(Context *cnt, MirInstrBlock *block);
+
+static void
+reach_eliminate_unused(Context *cnt);
+
 /***********/
 /*  RTTI   */
 /***********/
@@ -1943,6 +2016,77 @@ lookup_builtin_fn(Context *cnt, MirBuiltinIdKind kind)
 	return found->data.fn;
 }
 
+MirBuiltinIdKind
+lookup_intrinsic(ID *id)
+{
+	BL_ASSERT(id);
+	for (s32 i = MIR_BUILTIN_ID_INTRINSIC_MEMCPY; i <= MIR_BUILTIN_ID_INTRINSIC_ATOMIC_FENCE;
+	     ++i) {
+		if (builtin_ids[i].hash == id->hash) return (MirBuiltinIdKind)i;
+	}
+
+	return MIR_BUILTIN_ID_NONE;
+}
+
+MirType *
+atomic_value_type(MirType *ptr_type)
+{
+	if (!mir_is_pointer_type(ptr_type)) return NULL;
+	MirType *type = mir_deref_type(ptr_type);
+	return type && type->kind == MIR_TYPE_INT ? type : NULL;
+}
+
+bool
+is_intrinsic_signature_valid(MirFn *fn, const char **expected)
+{
+	MirType *           ret_type = fn->type->data.fn.ret_type;
+	TSmallArray_ArgPtr *args     = fn->type->data.fn.args;
+	const usize         argc     = args ? args->size : 0;
+	MirType *           value    = argc ? atomic_value_type(args->data[0]->type) : NULL;
+
+	switch (fn->intrinsic) {
+	case MIR_BUILTIN_ID_INTRINSIC_MEMCPY:
+		(*expected) = "fn (dest: *T, src: *T, size: <integer>)";
+		return argc == 3 && mir_is_pointer_type(args->data[0]->type) &&
+		       mir_is_pointer_type(args->data[1]->type) &&
+		       args->data[2]->type->kind == MIR_TYPE_INT && ret_type->kind == MIR_TYPE_VOID;
+
+	case MIR_BUILTIN_ID_INTRINSIC_MEMSET:
+		(*expected) = "fn (dest: *T, v: u8, size: <integer>)";
+		return argc == 3 && mir_is_pointer_type(args->data[0]->type) &&
+		       args->data[1]->type->kind == MIR_TYPE_INT &&
+		       args->data[1]->type->data.integer.bitcount == 8 &&
+		       args->data[2]->type->kind == MIR_TYPE_INT && ret_type->kind == MIR_TYPE_VOID;
+
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_LOAD:
+		(*expected) = "fn (ptr: *<integer>) <integer>";
+		return argc == 1 && value && type_cmp(ret_type, value);
+
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_STORE:
+		(*expected) = "fn (ptr: *<integer>, v: <integer>)";
+		return argc == 2 && value && type_cmp(args->data[1]->type, value) &&
+		       ret_type->kind == MIR_TYPE_VOID;
+
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_ADD:
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_XCHG:
+		(*expected) = "fn (ptr: *<integer>, v: <integer>) <integer>";
+		return argc == 2 && value && type_cmp(args->data[1]->type, value) &&
+		       type_cmp(ret_type, value);
+
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_CMPXCHG:
+		(*expected) = "fn (ptr: *<integer>, expected: <integer>, desired: <integer>) <integer>";
+		return argc == 3 && value && type_cmp(args->data[1]->type, value) &&
+		       type_cmp(args->data[2]->type, value) && type_cmp(ret_type, value);
+
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_FENCE:
+		(*expected) = "fn ()";
+		return argc == 0 && ret_type->kind == MIR_TYPE_VOID;
+
+	default:
+		BL_ABORT("Unknown intrinsic '%s'.", fn->linkage_name);
+	}
+}
+
 ID *
 lookup_builtins_rtti(Context *cnt)
 {
@@ -2898,6 +3042,7 @@ create_fn(Context *        cnt,
 	tmp->prototype    = &prototype->base;
 	tmp->emit_llvm    = emit_llvm;
 	tmp->is_global    = is_in_gscope;
+	tmp->intrinsic    = MIR_BUILTIN_ID_NONE;
 	return tmp;
 }
 
@@ -3915,7 +4060,7 @@ create_instr_const_ptr(Context *cnt, Ast *node, MirType *type, VMStackPtr ptr)
 }
 
 MirInstr *
-append_instr_const_string(Context *cnt, Ast *node, const char *str)
+create_instr_const_string(Context *cnt, Ast *node, const char *str)
 {
 	/* Build up string as compound expression of lenght and pointer to data. */
 	TSmallArray_InstrPtr *values = create_sarr(TSmallArray_InstrPtr, cnt->assembly);
@@ -3930,12 +4075,26 @@ append_instr_const_string(Context *cnt, Ast *node, const char *str)
 	tsa_push_InstrPtr(values, len);
 	tsa_push_InstrPtr(values, ptr);
 
-	MirInstr *compound =
-	    append_instr_compound_impl(cnt, node, cnt->builtin_types->t_string, values);
-	compound->value.is_comptime = true;
-	compound->value.addr_mode   = MIR_VAM_RVALUE;
+	MirInstrCompound *tmp       = create_instr(cnt, MIR_INSTR_COMPOUND, node);
+	tmp->base.value.type        = cnt->builtin_types->t_string;
+	tmp->base.value.is_comptime = true;
+	tmp->base.value.addr_mode   = MIR_VAM_RVALUE;
+	tmp->base.implicit          = true;
+	tmp->values                 = values;
+	tmp->is_naked               = true;
 
-	return compound;
+	ref_instr(len);
+	ref_instr(ptr);
+	return &tmp->base;
+}
+
+MirInstr *
+append_instr_const_string(Context *cnt, Ast *node, const char *str)
+{
+	MirInstr *tmp = create_instr_const_string(cnt, node, str);
+
+	append_current_block(cnt, tmp);
+	return tmp;
 }
 
 MirInstr *
@@ -4317,6 +4476,29 @@ analyze_resolve_type(Context *cnt, MirInstr *resolver_call, MirType **out_type)
 	if (analyze_instr(cnt, resolver_call).state != ANALYZE_PASSED)
 		return ANALYZE_RESULT(POSTPONE, 0);
 
+	if (cnt->vm_pool) {
+		MirInstrCall * call  = (MirInstrCall *)resolver_call;
+		VMPoolJobState state = vm_pool_commit(cnt->vm_pool, cnt->vm, call);
+
+		switch (state) {
+		case VM_POOL_JOB_NONE:
+			if (!vm_pool_can_execute(cnt->vm_pool, call)) break;
+			vm_pool_submit(cnt->vm_pool, cnt->assembly, call);
+			return ANALYZE_RESULT(POSTPONE, 0);
+
+		case VM_POOL_JOB_PENDING:
+			return ANALYZE_RESULT(POSTPONE, 0);
+
+		case VM_POOL_JOB_PASSED:
+			*out_type = MIR_CEV_READ_AS(MirType *, &resolver_call->value);
+			return ANALYZE_RESULT(PASSED, 0);
+
+		case VM_POOL_JOB_FAILED:
+			/* Execute again on main VM to report errors. */
+			break;
+		}
+	}
+
 	if (vm_execute_instr_top_level_call(
 	        cnt->vm, cnt->assembly, (MirInstrCall *)resolver_call)) {
 		*out_type = MIR_CEV_READ_AS(MirType *, &resolver_call->value);
@@ -5370,7 +5552,7 @@ analyze_instr_fn_proto(Context *cnt, MirInstrFnProto *fn_proto)
 
 	/* Setup function linkage name, this will be later used by LLVM backend. */
 	if (fn->id) {
-		if (IS_FLAG(fn->flags, FLAG_EXTERN)) {
+		if (IS_FLAG(fn->flags, FLAG_EXTERN) || IS_FLAG(fn->flags, FLAG_INTRINSIC)) {
 			fn->linkage_name = fn->id->str;
 		} else if (IS_FLAG(fn->flags, FLAG_PRIVATE)) {
 			fn->linkage_name = gen_uq_name(fn->id->str);
@@ -5391,6 +5573,33 @@ analyze_instr_fn_proto(Context *cnt, MirInstrFnProto *fn_proto)
 		BL_ASSERT(fn->linkage_name);
 		fn->dyncall.extern_entry = assembly_find_extern(cnt->assembly, fn->linkage_name);
 		fn->fully_analyzed       = true;
+	} else if (IS_FLAG(fn->flags, FLAG_INTRINSIC)) {
+		/* Intrinsic has no body, implementation is provided directly by the interpreter and
+		 * the LLVM backend. */
+		fn->intrinsic = lookup_intrinsic(fn->id);
+		if (fn->intrinsic == MIR_BUILTIN_ID_NONE) {
+			builder_msg(BUILDER_MSG_ERROR,
+			            ERR_UNKNOWN_INTRINSIC,
+			            fn_proto->base.node->location,
+			            BUILDER_CUR_WORD,
+			            "Unknown compiler intrinsic '%s'.",
+			            fn->linkage_name);
+			return ANALYZE_RESULT(FAILED, 0);
+		}
+
+		const char *expected = NULL;
+		if (!is_intrinsic_signature_valid(fn, &expected)) {
+			builder_msg(BUILDER_MSG_ERROR,
+			            ERR_INVALID_TYPE,
+			            fn_proto->base.node->location,
+			            BUILDER_CUR_WORD,
+			            "Invalid signature of compiler intrinsic '%s', expected '%s'.",
+			            fn->linkage_name,
+			            expected);
+			return ANALYZE_RESULT(FAILED, 0);
+		}
+
+		fn->fully_analyzed = true;
 	} else {
 		/* Add entry block of the function into analyze queue. */
 		MirInstr *entry_block = (MirInstr *)fn->first_block;
@@ -6312,6 +6521,13 @@ analyze_instr_call(Context *cnt, MirInstrCall *call)
 		return ANALYZE_RESULT(FAILED, 0);
 	}
 
+	if (type->data.fn.is_vargs) {
+		MirInstr *          callee = call->callee;
+		const AnalyzeResult r      = analyze_print_specialization(cnt, call);
+		if (r.state != ANALYZE_PASSED) return r;
+		if (call->callee != callee) type = call->callee->value.type;
+	}
+
 	if (is_direct_call) {
 		MirFn *fn = MIR_CEV_READ_AS(MirFn *, &call->callee->value);
 		BL_ASSERT(fn && "Missing function reference for direct call!");
@@ -6436,6 +6652,314 @@ analyze_instr_call(Context *cnt, MirInstrCall *call)
 	return ANALYZE_RESULT(PASSED, 0);
 }
 
+static inline bool
+is_gscope_fn(Context *cnt, MirFn *fn, MirBuiltinIdKind kind)
+{
+	ScopeEntry *found = scope_lookup(cnt->assembly->gscope, &builtin_ids[kind], true, false);
+	return found && found->kind == SCOPE_ENTRY_FN && found->data.fn == fn;
+}
+
+static inline MirBuiltinIdKind
+get_print_hook(MirType *type)
+{
+	if (!type) return MIR_BUILTIN_ID_NONE;
+
+	switch (type->kind) {
+	case MIR_TYPE_INT:
+		return type->data.integer.is_signed ? MIR_BUILTIN_ID_PRINT_S64
+		                                    : MIR_BUILTIN_ID_PRINT_U64;
+	case MIR_TYPE_REAL:
+		/* Shortest representation depends on precision of the source type. */
+		return type->data.real.bitcount == 32 ? MIR_BUILTIN_ID_PRINT_F32
+		                                      : MIR_BUILTIN_ID_PRINT_F64;
+	case MIR_TYPE_BOOL:
+		return MIR_BUILTIN_ID_PRINT_BOOL;
+	case MIR_TYPE_STRING:
+		return MIR_BUILTIN_ID_PRINT_STR;
+	default:
+		return MIR_BUILTIN_ID_NONE;
+	}
+}
+
+MirInstr *
+insert_print_stream_ref(Context *cnt, MirInstr *before, PrintLowering *pl)
+{
+	Ast *     node = pl->origin->base.node;
+	MirInstr *ref;
+
+	if (pl->stream_decl) {
+		MirInstrDeclDirectRef *direct_ref = create_instr(cnt, MIR_INSTR_DECL_DIRECT_REF, node);
+		direct_ref->ref                   = pl->stream_decl;
+		ref_instr(pl->stream_decl);
+		ref = &direct_ref->base;
+	} else {
+		MirInstrDeclRef *decl_ref = create_instr(cnt, MIR_INSTR_DECL_REF, node);
+		decl_ref->rid             = &builtin_ids[pl->stream_id];
+		decl_ref->scope           = cnt->assembly->gscope;
+		decl_ref->parent_unit     = pl->origin->parent_unit;
+		ref                       = &decl_ref->base;
+	}
+
+	MirInstr *addrof = create_instr_addrof(cnt, node, ref);
+	ref_instr(addrof);
+
+	insert_instr_before(before, ref);
+	insert_instr_before(before, addrof);
+
+	if (analyze_instr(cnt, ref).state != ANALYZE_PASSED) return NULL;
+	if (analyze_instr(cnt, addrof).state != ANALYZE_PASSED) return NULL;
+
+	return addrof;
+}
+
+MirInstr *
+insert_print_hook_call(Context *        cnt,
+                       MirInstr *       before,
+                       PrintLowering *  pl,
+                       MirBuiltinIdKind kind,
+                       MirInstr *       value)
+{
+	Ast *node = value ? value->node : pl->origin->base.node;
+
+	/* Value is already evaluated, stream pointer must be pushed after it. */
+	MirInstr *stream = insert_print_stream_ref(cnt, before, pl);
+	if (!stream) return NULL;
+
+	MirInstrDeclRef *callee = create_instr(cnt, MIR_INSTR_DECL_REF, node);
+	callee->rid             = &builtin_ids[kind];
+	callee->scope           = cnt->assembly->gscope;
+	callee->parent_unit     = pl->origin->parent_unit;
+
+	TSmallArray_InstrPtr *args = create_sarr(TSmallArray_InstrPtr, cnt->assembly);
+	tsa_push_InstrPtr(args, stream);
+	/* Value reference is inherited from original call. */
+	if (value) tsa_push_InstrPtr(args, value);
+
+	MirInstrCall *call         = create_instr(cnt, MIR_INSTR_CALL, node);
+	call->base.value.addr_mode = MIR_VAM_RVALUE;
+	call->callee               = &callee->base;
+	call->args                 = args;
+
+	ref_instr(&call->base);
+	ref_instr(&callee->base);
+
+	insert_instr_before(before, &callee->base);
+	insert_instr_before(before, &call->base);
+
+	if (analyze_instr(cnt, &callee->base).state != ANALYZE_PASSED) return NULL;
+	if (analyze_instr(cnt, &call->base).state != ANALYZE_PASSED) return NULL;
+
+	return &call->base;
+}
+
+MirInstr *
+insert_print_buffer_stream(Context *cnt, MirInstr *before)
+{
+	ScopeEntry *found = scope_lookup(
+	    cnt->assembly->gscope, &builtin_ids[MIR_BUILTIN_ID_PRINT_BUFFER_BEGIN], true, false);
+	BL_ASSERT(found && found->kind == SCOPE_ENTRY_FN);
+
+	/* Stream type is taken from the first argument of the begin hook. */
+	MirType *stream_type = found->data.fn->type->data.fn.args->data[0]->type;
+	stream_type          = mir_deref_type(stream_type);
+
+	MirInstrDeclVar *decl = create_instr(cnt, MIR_INSTR_DECL_VAR, before->node);
+	decl->base.value.type = cnt->builtin_types->t_void;
+	decl->base.ref_count  = NO_REF_COUNTING;
+	decl->var =
+	    create_var_impl(cnt, gen_uq_name(IMPL_PRINT_STREAM_TMP), stream_type, true, false, false);
+
+	insert_instr_before(before, &decl->base);
+	if (analyze_instr(cnt, &decl->base).state != ANALYZE_PASSED) return NULL;
+
+	return &decl->base;
+}
+
+AnalyzeResult
+analyze_print_specialization(Context *cnt, MirInstrCall *call)
+{
+	if (call->base.value.is_comptime) return ANALYZE_RESULT(PASSED, 0);
+	if (call->callee->kind != MIR_INSTR_DECL_REF) return ANALYZE_RESULT(PASSED, 0);
+
+	MirInstrDeclRef *origin = (MirInstrDeclRef *)call->callee;
+	ScopeEntry *     entry  = origin->scope_entry;
+	if (!entry || entry->kind != SCOPE_ENTRY_FN) return ANALYZE_RESULT(PASSED, 0);
+
+	/* print_log is not lowered, it passes whole format with []Any arguments to
+	 * _context.print_log_fn which can be replaced by user at runtime. */
+	MirFn *       fn        = entry->data.fn;
+	PrintLowering pl        = {.origin = origin};
+	usize         fmt_index = 0;
+	bool          is_buffer = false;
+	if (is_gscope_fn(cnt, fn, MIR_BUILTIN_ID_PRINT)) {
+		pl.stream_id = MIR_BUILTIN_ID_PRINT_STDOUT;
+	} else if (is_gscope_fn(cnt, fn, MIR_BUILTIN_ID_EPRINT)) {
+		pl.stream_id = MIR_BUILTIN_ID_PRINT_STDERR;
+	} else if (is_gscope_fn(cnt, fn, MIR_BUILTIN_ID_BPRINT)) {
+		/* Buffer is passed before format. */
+		fmt_index = 1;
+		is_buffer = true;
+	} else {
+		return ANALYZE_RESULT(PASSED, 0);
+	}
+
+	const usize argc = call->args ? call->args->size : 0;
+	if (argc <= fmt_index) return ANALYZE_RESULT(PASSED, 0);
+
+	MirInstr *fmt = call->args->data[fmt_index];
+	if (fmt->kind != MIR_INSTR_COMPOUND || !fmt->node ||
+	    fmt->node->kind != AST_EXPR_LIT_STRING) {
+		return ANALYZE_RESULT(PASSED, 0);
+	}
+
+	const char *format = fmt->node->data.expr_string.val;
+	usize       fmtc   = 0;
+	for (const char *c = format; *c; ++c) {
+		if (*c == '%') ++fmtc;
+	}
+
+	/* Unused arguments would stay unconsumed on VM stack. */
+	if (argc - fmt_index - 1 > fmtc) return ANALYZE_RESULT(PASSED, 0);
+
+	for (usize i = fmt_index + 1; i < argc; ++i) {
+		MirInstr *arg = call->args->data[i];
+		if (arg->kind == MIR_INSTR_CAST && ((MirInstrCast *)arg)->auto_cast) {
+			return ANALYZE_RESULT(PASSED, 0);
+		}
+
+		MirType *type = is_load_needed(arg) ? mir_deref_type(arg->value.type) : arg->value.type;
+		if (get_print_hook(type) == MIR_BUILTIN_ID_NONE) return ANALYZE_RESULT(PASSED, 0);
+	}
+
+	for (s32 kind = MIR_BUILTIN_ID_PRINT_BEGIN; kind <= MIR_BUILTIN_ID_PRINT_STDERR; ++kind) {
+		ID *        id    = &builtin_ids[kind];
+		ScopeEntry *found = scope_lookup(cnt->assembly->gscope, id, true, false);
+
+		/* API without print hooks. */
+		if (!found) return ANALYZE_RESULT(PASSED, 0);
+		if (found->kind == SCOPE_ENTRY_INCOMPLETE) return ANALYZE_RESULT(WAITING, id->hash);
+	}
+
+	/* Arguments are evaluated in reverse order before the callee reference, so all hooks are
+	 * inserted right before it. Values are consumed by writers in the same order as they lay
+	 * on the VM stack and nothing else can print between begin and end hook. */
+	MirInstr *before = &origin->base;
+
+	if (is_buffer) {
+		pl.stream_decl = insert_print_buffer_stream(cnt, before);
+		if (!pl.stream_decl) return ANALYZE_RESULT(FAILED, 0);
+
+		MirInstr *buf = call->args->data[0];
+		if (!insert_print_hook_call(
+		        cnt, before, &pl, MIR_BUILTIN_ID_PRINT_BUFFER_BEGIN, buf)) {
+			return ANALYZE_RESULT(FAILED, 0);
+		}
+	} else if (!insert_print_hook_call(cnt, before, &pl, MIR_BUILTIN_ID_PRINT_BEGIN, NULL)) {
+		return ANALYZE_RESULT(FAILED, 0);
+	}
+
+	TString *segment     = builder_create_cached_str();
+	usize    segment_len = 0;
+	usize    argi        = fmt_index + 1;
+
+	for (const char *c = format;; ++c) {
+		if (*c && *c != '%') {
+			tstring_append_n(segment, c, 1);
+			++segment_len;
+			continue;
+		}
+
+		MirInstr *value = NULL;
+		if (*c == '%') {
+			if (argi < argc) {
+				value = call->args->data[argi++];
+			} else {
+				tstring_append(segment, "(null)");
+				segment_len += strlen("(null)");
+				continue;
+			}
+		}
+
+		if (segment_len) {
+			MirInstr *str = create_instr_const_string(cnt, fmt->node, segment->data);
+			ref_instr(str);
+			insert_instr_before(before, str);
+			if (analyze_instr(cnt, str).state != ANALYZE_PASSED)
+				return ANALYZE_RESULT(FAILED, 0);
+
+			if (!insert_print_hook_call(cnt, before, &pl, MIR_BUILTIN_ID_PRINT_STR, str))
+				return ANALYZE_RESULT(FAILED, 0);
+
+			segment     = builder_create_cached_str();
+			segment_len = 0;
+		}
+
+		if (value) {
+			if (analyze_slot(cnt, &analyze_slot_conf_basic, &value, NULL) !=
+			    ANALYZE_PASSED) {
+				return ANALYZE_RESULT(FAILED, 0);
+			}
+
+			MirType *              value_type = NULL;
+			const MirBuiltinIdKind hook       = get_print_hook(value->value.type);
+			switch (hook) {
+			case MIR_BUILTIN_ID_PRINT_S64:
+				value_type = cnt->builtin_types->t_s64;
+				break;
+			case MIR_BUILTIN_ID_PRINT_U64:
+				value_type = cnt->builtin_types->t_u64;
+				break;
+			case MIR_BUILTIN_ID_PRINT_F64:
+				value_type = cnt->builtin_types->t_f64;
+				break;
+			default:
+				break;
+			}
+
+			if (value_type && !type_cmp(value->value.type, value_type)) {
+				value = insert_instr_cast(cnt, value, value_type);
+				if (analyze_instr(cnt, value).state != ANALYZE_PASSED)
+					return ANALYZE_RESULT(FAILED, 0);
+			}
+
+			if (!insert_print_hook_call(cnt, before, &pl, hook, value))
+				return ANALYZE_RESULT(FAILED, 0);
+		}
+
+		if (!*c) break;
+	}
+
+	/* Original call is replaced by the end hook returning count of printed characters. */
+	unref_instr(fn->prototype);
+	unref_instr(&origin->base);
+	erase_instr(&origin->base);
+	unref_instr(fmt);
+	erase_instr(fmt);
+
+	MirInstr *stream = insert_print_stream_ref(cnt, &call->base, &pl);
+	if (!stream) return ANALYZE_RESULT(FAILED, 0);
+
+	const MirBuiltinIdKind end_hook =
+	    is_buffer ? MIR_BUILTIN_ID_PRINT_BUFFER_END : MIR_BUILTIN_ID_PRINT_END;
+
+	MirInstrDeclRef *callee = create_instr(cnt, MIR_INSTR_DECL_REF, origin->base.node);
+	callee->rid             = &builtin_ids[end_hook];
+	callee->scope           = cnt->assembly->gscope;
+	callee->parent_unit     = origin->parent_unit;
+
+	insert_instr_before(&call->base, &callee->base);
+	ref_instr(&callee->base);
+
+	if (analyze_instr(cnt, &callee->base).state != ANALYZE_PASSED)
+		return ANALYZE_RESULT(FAILED, 0);
+
+	call->callee = &callee->base;
+	call->args   = create_sarr(TSmallArray_InstrPtr, cnt->assembly);
+	tsa_push_InstrPtr(call->args, stream);
+
+	return ANALYZE_RESULT(PASSED, 0);
+}
+
 AnalyzeResult
 analyze_instr_store(Context *cnt, MirInstrStore *store)
 {
@@ -6903,7 +7427,15 @@ analyze(Context *cnt)
 			LOG_ANALYZE_POSTPONE
 
 			skip = true;
-			if (postpone_loop_count++ < q->size) tlist_push_back(q, ip);
+			if (postpone_loop_count++ < q->size) {
+				tlist_push_back(q, ip);
+			} else if (cnt->vm_pool && vm_pool_is_pending(cnt->vm_pool)) {
+				/* Nothing can be analyzed without results of submitted compile time
+				 * calls, so we execute them all. */
+				vm_pool_flush(cnt->vm_pool);
+				postpone_loop_count = 0;
+				tlist_push_back(q, ip);
+			}
 			break;
 
 		case ANALYZE_WAITING: {
@@ -6960,6 +7492,170 @@ analyze_report_unresolved(Context *cnt)
 	}
 }
 
+bool
+reach_is_root(Context *cnt, MirFn *fn)
+{
+	/* Anonymous functions and test cases are kept. */
+	if (!fn->id) return true;
+	if (fn == cnt->entry_fn) return true;
+
+	/* Entry point called by runtime. */
+	if (is_builtin(fn->decl_node, MIR_BUILTIN_ID_OS_START)) return true;
+
+	/* Library bitcode can be linked into other assembly (-link-bc), so whole public API is
+	 * kept when there is no entry point or bitcode is emitted. */
+	const bool is_library = !cnt->entry_fn || builder.options.emit_bc;
+	if (!is_library || !fn->is_global) return false;
+	return !IS_FLAG(fn->flags, FLAG_PRIVATE) && !IS_FLAG(fn->flags, FLAG_EXTERN) &&
+	       !IS_FLAG(fn->flags, FLAG_INTRINSIC) && !IS_FLAG(fn->flags, FLAG_COMPILER);
+}
+
+void
+reach_fn(Context *cnt, MirFn *fn)
+{
+	if (!fn || fn->emit_llvm) return;
+	if (!thtbl_has_key(&cnt->reach.candidates, (u64)fn)) return;
+
+	fn->emit_llvm = true;
+
+	MirInstrBlock *block = fn->first_block;
+	while (block) {
+		tarray_push(&cnt->reach.queue, block);
+		block = (MirInstrBlock *)block->base.next;
+	}
+}
+
+void
+reach_var(Context *cnt, MirVar *var)
+{
+	if (!var->is_global || var->emit_llvm) return;
+	if (!thtbl_has_key(&cnt->reach.candidates, (u64)var)) return;
+
+	var->emit_llvm = true;
+
+	MirInstrBlock *init_block =
+	    thtbl_at(MirInstrBlock *, &cnt->reach.candidates, (u64)var);
+	if (!init_block) return;
+
+	init_block->emit_llvm = true;
+	tarray_push(&cnt->reach.queue, init_block);
+}
+
+void
+reach_block(Context *cnt, MirInstrBlock *block)
+{
+	MirInstr *instr = block->entry_instr;
+	for (; instr; instr = instr->next) {
+		/* Type resolvers are not generated. */
+		if (instr->value.type && instr->value.type->kind == MIR_TYPE_TYPE) continue;
+
+		switch (instr->kind) {
+		case MIR_INSTR_DECL_REF: {
+			ScopeEntry *entry = ((MirInstrDeclRef *)instr)->scope_entry;
+			if (entry->kind == SCOPE_ENTRY_FN) reach_fn(cnt, entry->data.fn);
+			if (entry->kind == SCOPE_ENTRY_VAR) reach_var(cnt, entry->data.var);
+			break;
+		}
+
+		case MIR_INSTR_DECL_DIRECT_REF: {
+			MirInstr *decl = ((MirInstrDeclDirectRef *)instr)->ref;
+			reach_var(cnt, ((MirInstrDeclVar *)decl)->var);
+			break;
+		}
+
+		case MIR_INSTR_CALL: {
+			/* Callee reference can be already erased from block. */
+			MirInstr *callee = ((MirInstrCall *)instr)->callee;
+			if (mir_is_comptime(callee) && callee->value.type->kind == MIR_TYPE_FN) {
+				reach_fn(cnt, MIR_CEV_READ_AS(MirFn *, &callee->value));
+			}
+			break;
+		}
+
+		case MIR_INSTR_UNREACHABLE:
+			reach_fn(cnt, ((MirInstrUnreachable *)instr)->abort_fn);
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+/*
+ * Whole API is preloaded into every assembly, so we generate LLVM IR only for functions and
+ * global variables reachable from the entry point (or tests when they should be generated).
+ * Libraries keep all public functions, see reach_is_root.
+ * RTTI is emitted lazily during IR generation so it's eliminated together with unused code.
+ */
+void
+reach_eliminate_unused(Context *cnt)
+{
+	THashTable *candidates = &cnt->reach.candidates;
+	TArray *    queue      = &cnt->reach.queue;
+	TArray      roots;
+
+	thtbl_init(candidates, sizeof(MirInstrBlock *), 4096);
+	tarray_init(queue, sizeof(MirInstrBlock *));
+	tarray_init(&roots, sizeof(MirFn *));
+
+	MirInstr *instr;
+	TARRAY_FOREACH(MirInstr *, &cnt->assembly->MIR.global_instrs, instr)
+	{
+		switch (instr->kind) {
+		case MIR_INSTR_FN_PROTO: {
+			MirFn *fn = MIR_CEV_READ_AS(MirFn *, &instr->value);
+			if (!fn || !fn->emit_llvm) break;
+
+			thtbl_insert(candidates, (u64)fn, (MirInstrBlock *)NULL);
+			fn->emit_llvm = false;
+			if (reach_is_root(cnt, fn)) tarray_push(&roots, fn);
+			break;
+		}
+
+		case MIR_INSTR_DECL_VAR: {
+			MirVar *var = ((MirInstrDeclVar *)instr)->var;
+			if (!var->is_global || var->is_implicit || !var->emit_llvm) break;
+
+			thtbl_insert(candidates, (u64)var, (MirInstrBlock *)NULL);
+			var->emit_llvm = false;
+			break;
+		}
+
+		case MIR_INSTR_BLOCK: {
+			/* Global initializer is terminated by SetInitializer of its variable. */
+			MirInstrBlock *block    = (MirInstrBlock *)instr;
+			MirInstr *     terminal = block->terminal;
+			if (!block->emit_llvm || !terminal) break;
+			if (terminal->kind != MIR_INSTR_SET_INITIALIZER) break;
+
+			MirInstr *decl = ((MirInstrSetInitializer *)terminal)->dest;
+			MirVar *  var  = ((MirInstrDeclVar *)decl)->var;
+			if (!thtbl_has_key(candidates, (u64)var)) break;
+
+			thtbl_at(MirInstrBlock *, candidates, (u64)var) = block;
+			block->emit_llvm                                 = false;
+			break;
+		}
+
+		default:
+			break;
+		}
+	}
+
+	MirFn *root;
+	TARRAY_FOREACH(MirFn *, &roots, root) reach_fn(cnt, root);
+
+	/* Queue grows during scanning. */
+	for (usize i = 0; i < queue->size; ++i) {
+		reach_block(cnt, tarray_at(MirInstrBlock *, queue, i));
+	}
+
+	tarray_terminate(&roots);
+	tarray_terminate(queue);
+	thtbl_terminate(candidates);
+}
+
 MirVar *
 rtti_gen(Context *cnt, MirType *type)
 {
@@ -8004,8 +8700,8 @@ ast_expr_lit_fn(Context *cnt, Ast *lit_fn, Ast *decl_node, bool is_in_gscope, u3
 	MIR_CEV_WRITE_AS(MirFn *, &fn_proto->base.value, fn);
 
 	/* function body */
-	/* external functions has no body */
-	if (IS_FLAG(flags, FLAG_EXTERN)) {
+	/* external functions and intrinsics has no body */
+	if (IS_FLAG(flags, FLAG_EXTERN) || IS_FLAG(flags, FLAG_INTRINSIC)) {
 		return &fn_proto->base;
 	}
 
@@ -9006,6 +9702,13 @@ _mir_cev_read(MirConstExprValue *value)
 }
 #endif
 
+ID *
+mir_get_builtin_id(MirBuiltinIdKind kind)
+{
+	BL_ASSERT(kind < _MIR_BUILTIN_ID_COUNT);
+	return &builtin_ids[kind];
+}
+
 void
 mir_type_to_str(char *buf, usize len, MirType *type, bool prefer_name)
 {
@@ -9210,11 +9913,24 @@ mir_run(Assembly *assembly)
 	if (builder.options.no_analyze) goto SKIP;
 
 	/* Analyze pass */
+	VMPool vm_pool;
+	if (builder.options.comptime_threads > 1) {
+		vm_pool_init(&vm_pool, (usize)builder.options.comptime_threads, VM_STACK_SIZE);
+		cnt.vm_pool = &vm_pool;
+	}
+
 	analyze(&cnt);
 	analyze_report_unresolved(&cnt);
 
+	if (cnt.vm_pool) {
+		vm_pool_terminate(cnt.vm_pool);
+		cnt.vm_pool = NULL;
+	}
+
 	if (builder.errorc) goto SKIP;
 
+	if (!builder.options.no_llvm) reach_eliminate_unused(&cnt);
+
 	if (builder.options.run_tests) execute_test_cases(&cnt);
 	if (builder.options.run) execute_entry_fn(&cnt);
 
@@ -222,6 +222,10 @@ struct MirFn {
 	u32         flags;
 	const char *test_case_desc;
 
+	/* Builtin id of compiler intrinsic implemented by this function (valid only for functions
+	 * marked as #intrinsic), MIR_BUILTIN_ID_NONE otherwise. */
+	MirBuiltinIdKind intrinsic;
+
 	/* pointer to the first block inside function body */
 	MirInstrBlock *first_block;
 	MirInstrBlock *last_block;
@@ -239,6 +243,13 @@ struct MirFn {
 		DCCallback *     extern_callback_handle;
 		DyncallCBContext context;
 	} dyncall;
+
+	/* Frame layout of local variables and instruction results used by VM, computed once before
+	 * the first call when frame slots are enabled. */
+	struct {
+		usize size;
+		bool  is_ready;
+	} vm_frame;
 };
 
 /* MEMBER */
@@ -388,6 +399,10 @@ struct MirInstr {
 	bool is_unrechable;
 	bool implicit; /* generated by compiler */
 
+	/* Position of result value relative to the frame beginning (used by VM when frame slots
+	 * are enabled); zero when value is passed on the stack. */
+	VMRelativeStackPtr vm_slot;
+
 	MirInstr *prev;
 	MirInstr *next;
 };
@@ -762,6 +777,10 @@ mir_type_to_str(char *buf, usize len, MirType *type, bool prefer_name);
 const char *
 mir_instr_name(MirInstr *instr);
 
+/* Get identifier of builtin symbol. */
+ID *
+mir_get_builtin_id(MirBuiltinIdKind kind);
+
 void
 mir_run(struct Assembly *assembly);
 
@@ -27,60 +27,171 @@
 //************************************************************************************************
 
 #include "config.h"
+#include "llvm_api.h"
 #include "stages.h"
 
 #ifdef BL_PLATFORM_WIN
 static const char *link_flag      = "";
 static const char *link_path_flag = "/LIBPATH";
-static const char *cmd            = "call \"%s\" %s && \"%s\" %s.obj /OUT:%s.exe %s";
+static const char *cmd            = "call \"%s\" %s && \"%s\" %s /OUT:%s.exe %s";
 #else
 static const char *link_flag      = "-l";
 static const char *link_path_flag = "-L";
-static const char *cmd            = "%s %s.o -o %s %s";
 #endif
 
 typedef struct {
 	Assembly *assembly;
+
+	/* Linker arguments (char *) in the same order as in the command line, used by in-process
+	 * LLD so arguments containing spaces are passed as they are. */
+	TArray args;
 } Context;
 
+/* Append single argument to the command line and to the argument list. */
+static void
+add_arg(Context *cnt, TString *buf, const char *arg)
+{
+	if (buf->len) tstring_append(buf, " ");
+	if (strchr(arg, ' ')) {
+		tstring_append(buf, "\"");
+		tstring_append(buf, arg);
+		tstring_append(buf, "\"");
+	} else {
+		tstring_append(buf, arg);
+	}
+
+	char *dup = strdup(arg);
+	if (!dup) BL_ABORT("bad alloc");
+	tarray_push(&cnt->args, dup);
+}
+
+/* Linker options from config file are space separated list of flags. */
+static void
+add_opt_args(Context *cnt, TString *buf, const char *opt)
+{
+	char *tmp = strdup(opt);
+	if (!tmp) BL_ABORT("bad alloc");
+
+	char *arg = strtok(tmp, " \t");
+	while (arg) {
+		add_arg(cnt, buf, arg);
+		arg = strtok(NULL, " \t");
+	}
+
+	free(tmp);
+}
+
 static void
 add_lib_paths(Context *cnt, TString *buf)
 {
+	TString tmp;
+	tstring_init(&tmp);
 
 	const char *dir;
 	TARRAY_FOREACH(const char *, &cnt->assembly->dl.lib_paths, dir)
 	{
-		tstring_append(buf, " ");
-		tstring_append(buf, link_path_flag);
-		tstring_append(buf, dir);
+		tstring_setf(&tmp, "%s%s", link_path_flag, dir);
+		add_arg(cnt, buf, tmp.data);
 	}
+
+	tstring_terminate(&tmp);
 }
 
 static void
 add_libs(Context *cnt, TString *buf)
 {
+	TString tmp;
+	tstring_init(&tmp);
+
 	NativeLib *lib;
 	for (usize i = 0; i < cnt->assembly->dl.libs.size; ++i) {
 		lib = &tarray_at(NativeLib, &cnt->assembly->dl.libs, i);
 		if (lib->is_internal) continue;
 		if (!lib->user_name) continue;
 
-		tstring_append(buf, " ");
-		tstring_append(buf, link_flag);
-		tstring_append(buf, lib->user_name);
+		tstring_setf(&tmp, "%s%s", link_flag, lib->user_name);
+		add_arg(cnt, buf, tmp.data);
+	}
+
+	tstring_terminate(&tmp);
+}
+
+/* Instrumented executable needs profile runtime library provided by LLVM (compiler-rt). */
+static void
+add_pgo_lib(Context *cnt, TString *buf)
+{
+	if (!builder.options.pgo_gen) return;
+	if (!conf_data_has_key(builder.conf, CONF_LINKER_PGO_LIB_KEY)) {
+		builder_msg(BUILDER_MSG_ERROR,
+		            ERR_LIB_NOT_FOUND,
+		            NULL,
+		            BUILDER_CUR_WORD,
+		            "Profile runtime library required by '-pgo-gen' is not set in config "
+		            "file (missing '%s' key)",
+		            CONF_LINKER_PGO_LIB_KEY);
+		return;
+	}
+
+#ifdef BL_PLATFORM_LINUX
+	/* Runtime start code references profile writer only weakly and LLVM does not emit any
+	 * runtime hook on Linux, so objects must be pulled from the archive explicitly. */
+	add_arg(cnt, buf, "-u");
+	add_arg(cnt, buf, "__llvm_profile_initialize_file");
+	add_arg(cnt, buf, "-u");
+	add_arg(cnt, buf, "__llvm_profile_write_file");
+#endif
+	add_arg(cnt, buf, conf_data_get_str(builder.conf, CONF_LINKER_PGO_LIB_KEY));
+}
+
+/* Object files can be split into multiple partitions by obj_writer. */
+static void
+add_obj_files(Context *cnt, TString *buf)
+{
+	const char *file;
+	TARRAY_FOREACH(const char *, &cnt->assembly->obj_files, file)
+	{
+		add_arg(cnt, buf, file);
 	}
 }
 
+#ifdef BL_USE_LLD
+/* Run LLD in-process with the same arguments as used for external linker command. */
+static void
+link_lld(Context *cnt)
+{
+	char *error_msg = NULL;
+	if (!llvm_lld_link((const char **)cnt->args.data, (s32)cnt->args.size, &error_msg)) {
+		builder_msg(BUILDER_MSG_ERROR,
+		            ERR_CANNOT_LINK,
+		            NULL,
+		            BUILDER_CUR_WORD,
+		            "In-process LLD link failed: %s",
+		            error_msg);
+		LLVMDisposeMessage(error_msg);
+	}
+}
+#endif
+
 void
 native_bin_run(Assembly *assembly)
 {
 	TString buf;
 	tstring_init(&buf);
 	Context cnt = {.assembly = assembly};
+	tarray_init(&cnt.args, sizeof(char *));
 
 #ifdef BL_PLATFORM_WIN
 	const char *linker_exec = conf_data_get_str(builder.conf, CONF_LINKER_EXEC_KEY);
 	{ /* setup link command */
+		TString obj_files;
+		tstring_init(&obj_files);
+		const char *file;
+		TARRAY_FOREACH(const char *, &assembly->obj_files, file)
+		{
+			if (i) tstring_append(&obj_files, " ");
+			tstring_append(&obj_files, file);
+		}
+
 		const char *vc_vars_all = conf_data_get_str(builder.conf, CONF_VC_VARS_ALL_KEY);
 		const char *vc_arch     = "x64"; // TODO: set by compiler target arch
 		const char *opt         = conf_data_get_str(builder.conf, CONF_LINKER_OPT_KEY);
@@ -89,32 +200,53 @@ native_bin_run(Assembly *assembly)
 		             vc_vars_all,
 		             vc_arch,
 		             linker_exec,
-		             assembly->name,
+		             obj_files.data,
 		             assembly->name,
 		             opt);
+		tstring_terminate(&obj_files);
 	}
 #else
-        const char *linker_exec = conf_data_get_str(builder.conf, CONF_LINKER_EXEC_KEY);
-        { /* setup link command */
-                const char *opt = conf_data_get_str(builder.conf, CONF_LINKER_OPT_KEY);
-                tstring_setf(&buf, cmd, linker_exec, assembly->name, assembly->name, opt);
-        }
+	const char *linker_exec = conf_data_get_str(builder.conf, CONF_LINKER_EXEC_KEY);
+	{ /* setup link command */
+		const char *opt = conf_data_get_str(builder.conf, CONF_LINKER_OPT_KEY);
+		add_arg(&cnt, &buf, linker_exec);
+		add_obj_files(&cnt, &buf);
+		add_arg(&cnt, &buf, "-o");
+		add_arg(&cnt, &buf, assembly->name);
+		add_opt_args(&cnt, &buf, opt);
+	}
 #endif
 
 	add_lib_paths(&cnt, &buf);
 	add_libs(&cnt, &buf);
+	add_pgo_lib(&cnt, &buf);
+	if (builder.errorc) goto DONE;
+
+#ifdef BL_USE_LLD
+	if (builder.options.use_lld) {
+		msg_log("Running LLD linker...");
+		if (builder.options.verbose) msg_log("%s", buf.data);
+		link_lld(&cnt);
+		goto DONE;
+	}
+#endif
 
 	msg_log("Running native linker...");
 	if (builder.options.verbose) msg_log("%s", buf.data);
-	/* TODO: handle error */
 	if (system(buf.data) != 0) {
 		builder_msg(BUILDER_MSG_ERROR,
-		            ERR_LIB_NOT_FOUND,
+		            ERR_CANNOT_LINK,
 		            NULL,
 		            BUILDER_CUR_WORD,
 		            "Native link execution failed '%s'",
-		            buf);
+		            buf.data);
+	}
+
+DONE:
+	for (usize i = 0; i < cnt.args.size; ++i) {
+		free(tarray_at(char *, &cnt.args, i));
 	}
 
+	tarray_terminate(&cnt.args);
 	tstring_terminate(&buf);
 }
@@ -32,15 +32,309 @@
 #include "stages.h"
 
 #ifdef BL_PLATFORM_WIN
+#include <process.h>
 #define OBJ_EXT ".obj"
+#define getpid _getpid
 #else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
 #define OBJ_EXT ".o"
 #endif
 
+/* Default size limit of object cache directory in MB. */
+#define OBJ_CACHE_SIZE_DEFAULT 1024
+
+/* Temporary files older than this (in seconds) are leftovers of interrupted builds. */
+#define OBJ_CACHE_TMP_STALE_TIME 3600
+#define OBJ_CACHE_TMP_EXT ".tmp"
+
+typedef struct {
+	char * filepath;
+	u64    size;
+	time_t mtime;
+} CacheEntry;
+
+static u64
+hash_bytes(u64 hash, const void *data, usize size)
+{
+	/* FNV-1a */
+	const u8 *ptr = data;
+	for (usize i = 0; i < size; ++i) {
+		hash ^= ptr[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+static u64
+hash_str(u64 hash, const char *str)
+{
+	/* include terminator to separate values */
+	return hash_bytes(hash, str, strlen(str) + 1);
+}
+
+/* Object cache key is hash of optimized module bitcode and all inputs of code generation. */
+static u64
+cache_key(Assembly *assembly, s32 partc)
+{
+	u64 hash = 14695981039346656037ULL;
+
+	LLVMMemoryBufferRef llvm_bc = LLVMWriteBitcodeToMemoryBuffer(assembly->llvm.module);
+	hash = hash_bytes(hash, LLVMGetBufferStart(llvm_bc), LLVMGetBufferSize(llvm_bc));
+	LLVMDisposeMemoryBuffer(llvm_bc);
+
+	const s32 opt_level = (s32)builder.options.opt_level;
+	hash                = hash_str(hash, BL_VERSION);
+	hash                = hash_str(hash, assembly->llvm.triple);
+	hash                = hash_str(hash, assembly->llvm.cpu);
+	hash                = hash_str(hash, assembly->llvm.features);
+	hash                = hash_bytes(hash, &opt_level, sizeof(opt_level));
+	hash                = hash_bytes(hash, &partc, sizeof(partc));
+	return hash;
+}
+
+static int
+cache_entry_cmp(const void *a, const void *b)
+{
+	const time_t ta = ((const CacheEntry *)a)->mtime;
+	const time_t tb = ((const CacheEntry *)b)->mtime;
+	return (ta > tb) - (ta < tb);
+}
+
+/* Remove least recently used objects until cache fits into size limit; objects with prefix
+ * 'keep' are never removed. Temporary files count into cache size too; stale ones are removed
+ * first, recent ones can be still written by another running compiler. */
+static void
+cache_evict(const char *dir, u64 max_size, const char *keep)
+{
+#ifndef BL_PLATFORM_WIN
+	DIR *d = opendir(dir);
+	if (!d) return;
+
+	TArray entries;
+	tarray_init(&entries, sizeof(CacheEntry));
+
+	const usize    ext_len     = strlen(OBJ_EXT);
+	const usize    tmp_ext_len = strlen(OBJ_CACHE_TMP_EXT);
+	const usize    keep_len    = strlen(keep);
+	const time_t   now         = time(NULL);
+	u64            total       = 0;
+	char           filepath[PATH_MAX];
+	struct stat    st;
+	struct dirent *e;
+	while ((e = readdir(d))) {
+		const usize len = strlen(e->d_name);
+		const bool  is_tmp =
+		    len > tmp_ext_len &&
+		    strcmp(&e->d_name[len - tmp_ext_len], OBJ_CACHE_TMP_EXT) == 0;
+		const bool is_obj =
+		    len > ext_len && strcmp(&e->d_name[len - ext_len], OBJ_EXT) == 0;
+		if (!is_tmp && !is_obj) continue;
+
+		snprintf(filepath, PATH_MAX, "%s" PATH_SEPARATOR "%s", dir, e->d_name);
+		if (stat(filepath, &st) != 0) continue;
+
+		if (is_tmp && difftime(now, st.st_mtime) >= OBJ_CACHE_TMP_STALE_TIME) {
+			if (remove(filepath) == 0) continue;
+		}
+
+		total += (u64)st.st_size;
+		if (is_tmp) continue;
+		if (strncmp(e->d_name, keep, keep_len) == 0) continue;
+
+		CacheEntry entry = {strdup(filepath), (u64)st.st_size, st.st_mtime};
+		tarray_push(&entries, entry);
+	}
+	closedir(d);
+
+	if (total > max_size) {
+		qsort(entries.data, entries.size, sizeof(CacheEntry), cache_entry_cmp);
+		for (usize i = 0; i < entries.size && total > max_size; ++i) {
+			CacheEntry *entry = &tarray_at(CacheEntry, &entries, i);
+			if (remove(entry->filepath) == 0) total -= entry->size;
+		}
+	}
+
+	CacheEntry *entry;
+	for (usize i = 0; i < entries.size; ++i) {
+		entry = &tarray_at(CacheEntry, &entries, i);
+		free(entry->filepath);
+	}
+
+	tarray_terminate(&entries);
+#else
+	(void)dir;
+	(void)max_size;
+	(void)keep;
+#endif
+}
+
+/* Lookup objects in cache or emit them into cache, returns false when cache cannot be used. */
+static bool
+emit_cached(Assembly *assembly, s32 partc)
+{
+	const char *dir = builder.options.obj_cache_dir;
+	if (!file_exists(dir) && !create_dir(dir)) {
+		msg_warning("Cannot create object cache directory '%s', cache is disabled.", dir);
+		return false;
+	}
+
+	char key[32];
+	snprintf(key, sizeof(key), "%016llx.", (unsigned long long)cache_key(assembly, partc));
+
+	TArray tmp_files;
+	tarray_init(&tmp_files, sizeof(char *));
+
+	bool hit = true;
+	for (s32 i = 0; i < partc; ++i) {
+		char filepath[PATH_MAX];
+		snprintf(filepath, PATH_MAX, "%s" PATH_SEPARATOR "%s%d%s", dir, key, i, OBJ_EXT);
+		if (!file_exists(filepath)) hit = false;
+		tarray_push(&assembly->obj_files, strdup(filepath));
+
+		/* Objects are emitted into temporary files renamed later, so other compiler
+		 * processes cannot see partially written object. */
+		char tmp[PATH_MAX];
+		snprintf(tmp, PATH_MAX, "%s.%d.tmp", filepath, (s32)getpid());
+		tarray_push(&tmp_files, strdup(tmp));
+	}
+
+	const char *filepath;
+	if (hit) {
+		if (builder.options.verbose) msg_log("Using cached object files '%s*'.", key);
+#ifndef BL_PLATFORM_WIN
+		/* Update last usage for LRU eviction. */
+		TARRAY_FOREACH(const char *, &assembly->obj_files, filepath) utime(filepath, NULL);
+#endif
+		goto DONE;
+	}
+
+	char *error_msg = NULL;
+	bool  failed    = false;
+	if (partc > 1) {
+		failed = !llvm_split_codegen(assembly->llvm.module,
+		                             assembly->llvm.TM,
+		                             (const char **)tmp_files.data,
+		                             (u32)partc,
+		                             &error_msg);
+	} else {
+		failed = LLVMTargetMachineEmitToFile(assembly->llvm.TM,
+		                                     assembly->llvm.module,
+		                                     tarray_at(char *, &tmp_files, 0),
+		                                     LLVMObjectFile,
+		                                     &error_msg);
+	}
+
+	if (failed) {
+		msg_error("Cannot emit object file with error: %s", error_msg);
+		LLVMDisposeMessage(error_msg);
+		TARRAY_FOREACH(const char *, &tmp_files, filepath) remove(filepath);
+		goto DONE;
+	}
+
+	for (usize i = 0; i < tmp_files.size; ++i) {
+		const char *tmp  = tarray_at(const char *, &tmp_files, i);
+		const char *dest = tarray_at(const char *, &assembly->obj_files, i);
+		/* Same object can be already stored by another process. */
+		if (rename(tmp, dest) != 0) remove(tmp);
+	}
+
+	const u64 max_size = builder.options.obj_cache_size ? builder.options.obj_cache_size
+	                                                     : OBJ_CACHE_SIZE_DEFAULT;
+	cache_evict(dir, max_size * 1024 * 1024, key);
+
+DONE:
+	TARRAY_FOREACH(const char *, &tmp_files, filepath) free((char *)filepath);
+	tarray_terminate(&tmp_files);
+	return true;
+}
+
+/* Create in-memory file for object and register it as assembly object file, returns -1 when
+ * in-memory files cannot be used (object file is written on disk then). */
+static s32
+create_mem_file(Assembly *assembly)
+{
+	if (builder.options.keep_obj) return -1;
+
+	char      path[PATH_MAX];
+	s32       fd = mem_file_create(assembly->name, path, PATH_MAX);
+	if (fd == -1) return -1;
+
+	tarray_push(&assembly->mem_files, fd);
+	tarray_push(&assembly->obj_files, strdup(path));
+	return fd;
+}
+
+/* Emit object file into memory buffer and stream it to in-memory file, so nothing is written
+ * into working directory. */
+static bool
+emit_to_memory(Assembly *assembly)
+{
+	const s32 fd = create_mem_file(assembly);
+	if (fd == -1) return false;
+
+	LLVMMemoryBufferRef llvm_buf  = NULL;
+	char *              error_msg = NULL;
+	if (LLVMTargetMachineEmitToMemoryBuffer(
+	        assembly->llvm.TM, assembly->llvm.module, LLVMObjectFile, &error_msg, &llvm_buf)) {
+		msg_error("Cannot emit object file with error: %s", error_msg);
+		LLVMDisposeMessage(error_msg);
+		return true;
+	}
+
+	if (!mem_file_write(fd, LLVMGetBufferStart(llvm_buf), LLVMGetBufferSize(llvm_buf))) {
+		msg_error("Cannot write object file into memory.");
+	}
+
+	LLVMDisposeMemoryBuffer(llvm_buf);
+	return true;
+}
+
+/* Emit object files of all module partitions in parallel. */
+static void
+emit_split(Assembly *assembly, s32 partc)
+{
+	const usize len = strlen(assembly->name) + strlen(OBJ_EXT) + 16;
+	for (s32 i = 0; i < partc; ++i) {
+		/* Partitions are written by LLVM into files, in-memory file can be opened by path. */
+		if (create_mem_file(assembly) != -1) continue;
+
+		char *filename = bl_malloc(sizeof(char) * len);
+		if (!filename) BL_ABORT("bad alloc");
+		snprintf(filename, len, "%s.%d%s", assembly->name, i, OBJ_EXT);
+		remove(filename);
+		tarray_push(&assembly->obj_files, filename);
+	}
+
+	char *error_msg = NULL;
+	if (!llvm_split_codegen(assembly->llvm.module,
+	                        assembly->llvm.TM,
+	                        (const char **)assembly->obj_files.data,
+	                        (u32)partc,
+	                        &error_msg)) {
+		msg_error("Cannot emit object files with error: %s", error_msg);
+		LLVMDisposeMessage(error_msg);
+	}
+}
+
 /* Emit assembly object file. */
 void
 obj_writer_run(Assembly *assembly)
 {
+	if (builder.options.obj_cache_dir) {
+		const s32 partc = builder.options.codegen_threads > 1 ? builder.options.codegen_threads : 1;
+		if (emit_cached(assembly, partc)) return;
+	}
+
+	if (builder.options.codegen_threads > 1) {
+		emit_split(assembly, builder.options.codegen_threads);
+		return;
+	}
+
+	if (emit_to_memory(assembly)) return;
+
 	char *filename = bl_malloc(sizeof(char) * (strlen(assembly->name) + strlen(OBJ_EXT) + 1));
 	if (!filename) BL_ABORT("bad alloc");
 	strcpy(filename, assembly->name);
@@ -57,5 +351,5 @@ obj_writer_run(Assembly *assembly)
 		return;
 	}
 
-	bl_free(filename);
+	tarray_push(&assembly->obj_files, filename);
 }
@@ -80,6 +80,7 @@ typedef enum {
 	HD_LINE      = 1 << 10,
 	HD_BASE      = 1 << 11,
 	HD_META      = 1 << 12,
+	HD_INTRINSIC = 1 << 13,
 } HashDirective;
 
 typedef struct {
@@ -348,7 +349,7 @@ parse_expr_ref(Context *cnt)
  * Try to parse hash directive. List of enabled directives can be set by 'expected_mask',
  * 'satisfied' is optional output set to parsed directive id if there is one.
  *
- * <#><load|link|test|extern|compiler|inline|no_inline|base>
+ * <#><load|link|test|extern|compiler|inline|no_inline|base|intrinsic>
  */
 Ast *
 parse_hash_directive(Context *cnt, s32 expected_mask, HashDirective *satisfied)
@@ -593,6 +594,20 @@ parse_hash_directive(Context *cnt, s32 expected_mask, HashDirective *satisfied)
 		return NULL;
 	}
 
+	if (strcmp(directive, "intrinsic") == 0) {
+		set_satisfied(HD_INTRINSIC);
+		if (IS_NOT_FLAG(expected_mask, HD_INTRINSIC)) {
+			PARSE_ERROR(ERR_UNEXPECTED_DIRECTIVE,
+			            tok_directive,
+			            BUILDER_CUR_WORD,
+			            "Unexpected directive.");
+			return ast_create_node(
+			    cnt->ast_arena, AST_BAD, tok_directive, scope_get(cnt));
+		}
+
+		return NULL;
+	}
+
 	if (strcmp(directive, "inline") == 0) {
 		set_satisfied(HD_INLINE);
 		if (IS_NOT_FLAG(expected_mask, HD_INLINE)) {
@@ -1072,6 +1087,7 @@ hash_directive_to_flags(HashDirective hd, u32 *out_flags)
 		FLAG_CASE(HD_COMPILER, FLAG_COMPILER);
 		FLAG_CASE(HD_INLINE, FLAG_INLINE);
 		FLAG_CASE(HD_NO_INLINE, FLAG_NO_INLINE);
+		FLAG_CASE(HD_INTRINSIC, FLAG_INTRINSIC);
 	default:
 		break;
 	}
@@ -1613,7 +1629,8 @@ parse_expr_lit_fn(Context *cnt)
 	/* parse flags */
 	Ast *curr_decl = decl_get(cnt);
 	if (curr_decl && curr_decl->kind == AST_DECL_ENTITY) {
-		u32 accepted = HD_EXTERN | HD_NO_INLINE | HD_INLINE | HD_COMPILER;
+		u32 accepted =
+		    HD_EXTERN | HD_NO_INLINE | HD_INLINE | HD_COMPILER | HD_INTRINSIC;
 		u32 flags    = 0;
 		while (true) {
 			HashDirective found = HD_NONE;
@@ -2091,7 +2108,7 @@ parse_decl(Context *cnt)
 		/* parse declaration expression */
 		decl->data.decl_entity.value = parse_expr(cnt);
 
-		if (!(decl->data.decl_entity.flags & (FLAG_EXTERN))) {
+		if (!(decl->data.decl_entity.flags & (FLAG_EXTERN | FLAG_INTRINSIC))) {
 			if (!decl->data.decl_entity.value) {
 				PARSE_ERROR(ERR_EXPECTED_INITIALIZATION,
 				            tok_assign,
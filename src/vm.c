@@ -35,6 +35,7 @@
 #define VERBOSE_EXEC false
 #define CHCK_STACK true
 #define PTR_SIZE sizeof(void *) /* HACK: can cause problems with different build targets. */
+#define TIMEOUT_CHECK_PERIOD 4096 /* count of executed instructions between timeout checks */
 
 // Debug helpers
 #if BL_DEBUG && VERBOSE_EXEC
@@ -125,7 +126,26 @@
 	}
 #endif
 
+/* Execution errors are not reported by quiet VM instances. */
+#define VM_ERROR(vm, format, ...)                                                                  \
+	{                                                                                          \
+		if (!(vm)->quiet) msg_error(format, ##__VA_ARGS__);                                \
+	}
+
 TSMALL_ARRAY_TYPE(ConstExprValue, MirConstExprValue, 32);
+TSMALL_ARRAY_TYPE(FnPtr, MirFn *, 16);
+
+typedef struct VMPoolJob {
+	MirInstrCall *   call;
+	struct Assembly *assembly;
+	VMStackPtr       result; /* copy of the return value */
+	VMPoolJobState   state;
+	time_t           start_time; /* wall-clock time when execution started on worker */
+	bool             is_commited;
+} VMPoolJob;
+
+/* Pool being flushed, worker threads have no arguments. */
+static VMPool *flushed_pool = NULL;
 
 /*************/
 /* fwd decls */
@@ -175,6 +195,30 @@ execute_fn_top_level(VM *vm, MirInstr *call, VMStackPtr *out_ptr);
 static bool
 execute_fn_impl_top_level(VM *vm, MirFn *fn, TSmallArray_ConstExprValue *args, VMStackPtr *out_ptr);
 
+static bool
+pool_can_execute_fn(MirFn *fn, TSmallArray_FnPtr *visited);
+
+static void
+pool_execute_job(VM *vm, VMPoolJob *job);
+
+static void
+pool_worker(void);
+
+static void
+reset_limits(VM *vm);
+
+/* Check execution limits set by user, report error and return true when any is reached. */
+static bool
+check_limits(VM *vm, MirInstr *instr);
+
+/* Write pending content of process-wide print streams and release their locks possibly held by
+ * aborted execution. */
+static void
+flush_print_streams(VM *vm);
+
+static MirMember *
+find_stream_member(MirType *type, const char *name);
+
 static bool
 _execute_fn_top_level(VM *                        vm,
                       MirFn *                     fn,
@@ -189,6 +233,12 @@ interp_instr(VM *vm, MirInstr *instr);
 static void
 interp_extern_call(VM *vm, MirFn *fn, MirInstrCall *call);
 
+static void
+interp_intrinsic_call(VM *vm, MirFn *fn, MirInstrCall *call);
+
+static void
+interp_intrinsic_atomic_call(VM *vm, MirFn *fn, MirInstrCall *call);
+
 static void
 interp_instr_toany(VM *vm, MirInstrToAny *toany);
 
@@ -350,7 +400,7 @@ stack_alloc(VM *vm, usize size)
 	size = stack_alloc_size(size);
 	vm->stack->used_bytes += size;
 	if (vm->stack->used_bytes > vm->stack->allocated_bytes) {
-		msg_error("Stack overflow!!!");
+		VM_ERROR(vm, "Stack overflow!!!");
 		exec_abort(vm, 10);
 	}
 
@@ -461,12 +511,37 @@ stack_rel_to_abs_ptr(VM *vm, VMRelativeStackPtr rel_ptr, bool ignore)
 	return base + rel_ptr;
 }
 
+/* Frame slot of the instruction result value located in the 'frame'. */
+static inline VMStackPtr
+frame_slot_ptr(VMFrame *frame, MirInstr *instr)
+{
+	BL_ASSERT(frame && instr->vm_slot);
+	return (VMStackPtr)frame + instr->vm_slot;
+}
+
 /* Fetch value into Temp  */
 static inline VMStackPtr
-fetch_value(VM *vm, MirConstExprValue *v)
+fetch_value(VM *vm, MirInstr *instr)
 {
-	if (v->is_comptime) return v->data;
-	return stack_pop(vm, v->type);
+	if (instr->value.is_comptime) return instr->value.data;
+	if (instr->vm_slot) return frame_slot_ptr(vm->stack->ra, instr);
+	return stack_pop(vm, instr->value.type);
+}
+
+/* Push result value of the instruction on the stack or write it directly into the instruction
+ * slot in current frame when frame slots are used. */
+static inline void
+push_result(VM *vm, MirInstr *instr, void *value)
+{
+	MirType *type = instr->value.type;
+	BL_ASSERT(type);
+
+	if (instr->vm_slot) {
+		memcpy(frame_slot_ptr(vm->stack->ra, instr), value, type->store_size_bytes);
+		return;
+	}
+
+	stack_push(vm, value, type);
 }
 
 static inline MirInstr *
@@ -513,6 +588,67 @@ stack_alloc_local_vars(VM *vm, MirFn *fn)
 	}
 }
 
+static inline usize
+frame_slot_size(usize size)
+{
+	return size + (MAX_ALIGNMENT - (size % MAX_ALIGNMENT)) % MAX_ALIGNMENT;
+}
+
+/* Compute frame layout of the function; every local variable and every runtime instruction
+ * producing some value gets fixed position relative to the frame beginning. Layout is computed
+ * only once for every function and reused by all later calls. */
+static void
+frame_layout(MirFn *fn)
+{
+	BL_ASSERT(fn->fully_analyzed && "Frame layout of not fully analyzed function!");
+
+	/* Frame data starts right after the frame header allocated by push_ra. */
+	const usize        header_size = stack_alloc_size(sizeof(VMFrame));
+	VMRelativeStackPtr offset      = (VMRelativeStackPtr)header_size;
+
+	TArray *vars = fn->variables;
+	MirVar *var;
+	TARRAY_FOREACH(MirVar *, vars, var)
+	{
+		if (var->value.is_comptime) continue;
+		var->rel_stack_ptr = offset;
+		offset += frame_slot_size(var->value.type->store_size_bytes);
+	}
+
+	MirInstrBlock *block = fn->first_block;
+	while (block) {
+		MirInstr *instr = block->entry_instr;
+		while (instr) {
+			MirType *type = instr->value.type;
+			if (!instr->value.is_comptime && type && type->store_size_bytes > 0) {
+				instr->vm_slot = offset;
+				offset += frame_slot_size(type->store_size_bytes);
+			}
+
+			instr = instr->next;
+		}
+
+		block = (MirInstrBlock *)block->base.next;
+	}
+
+	fn->vm_frame.size     = (usize)offset - header_size;
+	fn->vm_frame.is_ready = true;
+}
+
+/* Allocate all function local data on the stack, this must be called right after push_ra. */
+static inline void
+stack_alloc_frame(VM *vm, MirFn *fn)
+{
+	BL_ASSERT(fn);
+	if (!builder.options.vm_frame_slots) {
+		stack_alloc_local_vars(vm, fn);
+		return;
+	}
+
+	if (!fn->vm_frame.is_ready) frame_layout(fn);
+	if (fn->vm_frame.size) stack_alloc(vm, fn->vm_frame.size);
+}
+
 /********/
 /* impl */
 /********/
@@ -904,7 +1040,7 @@ print_call_stack(VM *vm, usize max_nesting)
 	VMFrame * fr    = vm->stack->ra;
 	usize     n     = 0;
 
-	if (!instr) return;
+	if (!instr || vm->quiet) return;
 	/* print last instruction */
 	builder_msg(BUILDER_MSG_LOG, 0, instr->node->location, BUILDER_CUR_WORD, "");
 
@@ -1152,13 +1288,23 @@ _dyncall_generate_signature(VM *vm, MirType *type)
 const char *
 dyncall_generate_signature(VM *vm, MirType *type)
 {
+	/* Types are unique by ID hash, so every signature is generated only once. */
+	THashTable *cache = &vm->dyncall_sig_cache;
+	TIterator   it    = thtbl_find(cache, type->id.hash);
+	if (!TITERATOR_EQUAL(it, thtbl_end(cache))) return thtbl_iter_peek_value(char *, it);
+
 	TSmallArray_Char *tmp = &vm->dyncall_sig_tmp;
 	tmp->size             = 0; /* reset size */
 
 	_dyncall_generate_signature(vm, type);
 	tsa_push_Char(tmp, '\0');
 
-	return tmp->data;
+	char *sig = bl_malloc(tmp->size);
+	if (!sig) BL_ABORT("bad alloc");
+	memcpy(sig, tmp->data, tmp->size);
+
+	thtbl_insert(cache, type->id.hash, sig);
+	return sig;
 }
 
 DCCallback *
@@ -1276,7 +1422,7 @@ interp_extern_call(VM *vm, MirFn *fn, MirInstrCall *call)
 
 	/* call setup and clenup */
 	if (!fn->dyncall.extern_entry) {
-		msg_error("External function '%s' not found!", fn->linkage_name);
+		VM_ERROR(vm, "External function '%s' not found!", fn->linkage_name);
 		exec_abort(vm, 0);
 		return;
 	}
@@ -1291,7 +1437,7 @@ interp_extern_call(VM *vm, MirFn *fn, MirInstrCall *call)
 		MirInstr *arg_value;
 		TSA_FOREACH(arg_values, arg_value)
 		{
-			arg_ptr = fetch_value(vm, &arg_value->value);
+			arg_ptr = fetch_value(vm, arg_value);
 			dyncall_push_arg(vm, arg_ptr, arg_value->value.type);
 		}
 	}
@@ -1367,7 +1513,113 @@ interp_extern_call(VM *vm, MirFn *fn, MirInstrCall *call)
 
 	/* PUSH result only if it is used */
 	if (call->base.ref_count > 1 && does_return) {
-		stack_push(vm, (VMStackPtr)&result, ret_type);
+		push_result(vm, &call->base, (VMStackPtr)&result);
+	}
+}
+
+void
+interp_intrinsic_call(VM *vm, MirFn *fn, MirInstrCall *call)
+{
+	if (fn->intrinsic >= MIR_BUILTIN_ID_INTRINSIC_ATOMIC_LOAD) {
+		interp_intrinsic_atomic_call(vm, fn, call);
+		return;
+	}
+
+	/* Intrinsics are executed directly on host without any frame setup, all arguments are
+	 * poped from the stack in order they are defined. */
+	TSmallArray_InstrPtr *args = call->args;
+	BL_ASSERT(args && args->size == 3 && "Invalid count of intrinsic arguments!");
+
+	VMStackPtr dest_ptr = fetch_value(vm, args->data[0]);
+	VMStackPtr arg1_ptr = fetch_value(vm, args->data[1]);
+	VMStackPtr size_ptr = fetch_value(vm, args->data[2]);
+
+	VMStackPtr dest = vm_read_ptr(args->data[0]->value.type, dest_ptr);
+	const u64  size = vm_read_int(args->data[2]->value.type, size_ptr);
+
+	if (size && !dest) {
+		VM_ERROR(vm, "Dereferencing null pointer!");
+		exec_abort(vm, 0);
+		return;
+	}
+
+	switch (fn->intrinsic) {
+	case MIR_BUILTIN_ID_INTRINSIC_MEMCPY: {
+		VMStackPtr src = vm_read_ptr(args->data[1]->value.type, arg1_ptr);
+		if (size && !src) {
+			VM_ERROR(vm, "Dereferencing null pointer!");
+			exec_abort(vm, 0);
+			return;
+		}
+
+		memcpy(dest, src, size);
+		break;
+	}
+
+	case MIR_BUILTIN_ID_INTRINSIC_MEMSET: {
+		const u8 v = (u8)vm_read_int(args->data[1]->value.type, arg1_ptr);
+		memset(dest, v, size);
+		break;
+	}
+
+	default:
+		BL_ABORT("Unknown intrinsic '%s'.", fn->linkage_name);
+	}
+}
+
+void
+interp_intrinsic_atomic_call(VM *vm, MirFn *fn, MirInstrCall *call)
+{
+	/* Compile-time execution runs in single thread, so atomic operations are executed as
+	 * regular memory access. */
+	if (fn->intrinsic == MIR_BUILTIN_ID_INTRINSIC_ATOMIC_FENCE) return;
+
+	TSmallArray_InstrPtr *args = call->args;
+	BL_ASSERT(args && args->size >= 1 && "Invalid count of intrinsic arguments!");
+
+	MirType *  ptr_type = args->data[0]->value.type;
+	MirType *  type     = mir_deref_type(ptr_type);
+	VMStackPtr dest     = vm_read_ptr(ptr_type, fetch_value(vm, args->data[0]));
+
+	/* Values must be read before anything is pushed on the stack. */
+	u64 v1 = 0;
+	u64 v2 = 0;
+	if (args->size > 1) v1 = vm_read_int(type, fetch_value(vm, args->data[1]));
+	if (args->size > 2) v2 = vm_read_int(type, fetch_value(vm, args->data[2]));
+
+	if (!dest) {
+		VM_ERROR(vm, "Dereferencing null pointer!");
+		exec_abort(vm, 0);
+		return;
+	}
+
+	/* All read-modify-write operations return previous value. */
+	const u64 prev = vm_read_int(type, dest);
+
+	switch (fn->intrinsic) {
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_LOAD:
+		break;
+
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_STORE:
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_XCHG:
+		vm_write_int(type, dest, v1);
+		break;
+
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_ADD:
+		vm_write_int(type, dest, prev + v1);
+		break;
+
+	case MIR_BUILTIN_ID_INTRINSIC_ATOMIC_CMPXCHG:
+		if (prev == v1) vm_write_int(type, dest, v2);
+		break;
+
+	default:
+		BL_ABORT("Unknown intrinsic '%s'.", fn->linkage_name);
+	}
+
+	/* PUSH result only if it is used */
+	if (call->base.ref_count > 1 && call->base.value.type->kind != MIR_TYPE_VOID) {
+		push_result(vm, &call->base, (VMStackPtr)&prev);
 	}
 }
 
@@ -1383,6 +1635,221 @@ execute_fn_impl_top_level(VM *vm, MirFn *fn, TSmallArray_ConstExprValue *args, V
 	return _execute_fn_top_level(vm, fn, NULL, args, out_ptr);
 }
 
+static inline bool
+is_mutable_global(MirVar *var)
+{
+	return var->is_global && var->is_mutable;
+}
+
+bool
+pool_can_execute_fn(MirFn *fn, TSmallArray_FnPtr *visited)
+{
+	if (IS_FLAG(fn->flags, FLAG_INTRINSIC)) return true;
+	if (IS_FLAG(fn->flags, FLAG_EXTERN) || !fn->fully_analyzed) return false;
+
+	/* Function is already checked or it's just being checked (recursion). */
+	MirFn *it;
+	TSA_FOREACH(visited, it)
+	{
+		if (it == fn) return true;
+	}
+
+	tsa_push_FnPtr(visited, fn);
+
+	/* Frame layout is computed here, so worker threads never modify the function. */
+	if (!fn->vm_frame.is_ready) frame_layout(fn);
+
+	MirInstrBlock *block = fn->first_block;
+	while (block) {
+		MirInstr *instr = block->entry_instr;
+		while (instr) {
+			switch (instr->kind) {
+			case MIR_INSTR_CALL: {
+				MirInstrCall *call = (MirInstrCall *)instr;
+				if (mir_is_comptime(&call->base)) break;
+
+				/* Functions called via pointer are not known. */
+				if (!mir_is_comptime(call->callee)) return false;
+				if (call->callee->value.type->kind != MIR_TYPE_FN) return false;
+				if (!pool_can_execute_fn(get_callee(call), visited)) return false;
+				break;
+			}
+
+			case MIR_INSTR_DECL_REF: {
+				ScopeEntry *entry = ((MirInstrDeclRef *)instr)->scope_entry;
+				if (entry->kind == SCOPE_ENTRY_VAR && is_mutable_global(entry->data.var))
+					return false;
+				break;
+			}
+
+			case MIR_INSTR_DECL_DIRECT_REF: {
+				MirInstr *ref = ((MirInstrDeclDirectRef *)instr)->ref;
+				if (ref->kind == MIR_INSTR_DECL_VAR &&
+				    is_mutable_global(((MirInstrDeclVar *)ref)->var))
+					return false;
+				break;
+			}
+
+			default:
+				break;
+			}
+
+			instr = instr->next;
+		}
+
+		block = (MirInstrBlock *)block->base.next;
+	}
+
+	return true;
+}
+
+void
+pool_execute_job(VM *vm, VMPoolJob *job)
+{
+	MirFn *    fn      = get_callee(job->call);
+	VMStackPtr ret_ptr = NULL;
+
+	vm->assembly = job->assembly;
+	reset_stack(vm->stack);
+	reset_limits(vm);
+	job->start_time = vm->start_time;
+
+	if (execute_fn_impl_top_level(vm, fn, NULL, &ret_ptr) && ret_ptr) {
+		memcpy(job->result, ret_ptr, job->call->base.value.type->store_size_bytes);
+		job->state = VM_POOL_JOB_PASSED;
+	} else {
+		job->state = VM_POOL_JOB_FAILED;
+	}
+}
+
+void
+pool_worker(void)
+{
+	VMPool *pool = flushed_pool;
+	BL_ASSERT(pool);
+
+	thread_mutex_lock(pool->mutex);
+	VM *vm = &pool->vms[pool->next_vm++];
+	thread_mutex_unlock(pool->mutex);
+
+	while (true) {
+		VMPoolJob *job = NULL;
+
+		thread_mutex_lock(pool->mutex);
+		if (pool->next_job < pool->pending.size) {
+			job = tarray_at(VMPoolJob *, &pool->pending, pool->next_job++);
+		}
+		thread_mutex_unlock(pool->mutex);
+
+		if (!job) break;
+		pool_execute_job(vm, job);
+	}
+}
+
+void
+reset_limits(VM *vm)
+{
+	vm->steps       = 0;
+	vm->start_time  = vm->resume_time ? vm->resume_time : time(NULL);
+	vm->resume_time = 0;
+}
+
+bool
+check_limits(VM *vm, MirInstr *instr)
+{
+	const u64 max_steps = builder.options.vm_max_steps;
+	const s32 timeout   = builder.options.vm_timeout;
+
+	++vm->steps;
+	if (max_steps && vm->steps > max_steps) {
+		if (!vm->quiet) {
+			builder_msg(BUILDER_MSG_ERROR,
+			            ERR_COMPTIME_LIMIT,
+			            instr->node ? instr->node->location : NULL,
+			            BUILDER_CUR_WORD,
+			            "Compile time execution exceeded limit of %llu instructions.",
+			            (unsigned long long)max_steps);
+		}
+		return true;
+	}
+
+	/* Reading time is not for free, so we do it only once in a while. */
+	if (timeout && vm->steps % TIMEOUT_CHECK_PERIOD == 0 &&
+	    difftime(time(NULL), vm->start_time) >= (f64)timeout) {
+		if (!vm->quiet) {
+			builder_msg(BUILDER_MSG_ERROR,
+			            ERR_COMPTIME_LIMIT,
+			            instr->node ? instr->node->location : NULL,
+			            BUILDER_CUR_WORD,
+			            "Compile time execution exceeded time limit of %d seconds.",
+			            timeout);
+		}
+		return true;
+	}
+
+	return false;
+}
+
+MirMember *
+find_stream_member(MirType *type, const char *name)
+{
+	MirMember *member;
+	TSA_FOREACH(type->data.strct.members, member)
+	{
+		if (strcmp(member->id->str, name) == 0) return member;
+	}
+
+	return NULL;
+}
+
+void
+flush_print_streams(VM *vm)
+{
+	/* Pool workers never touch mutable globals. */
+	if (vm->quiet || !vm->assembly) return;
+
+	const MirBuiltinIdKind streams[] = {MIR_BUILTIN_ID_PRINT_STDOUT,
+	                                    MIR_BUILTIN_ID_PRINT_STDERR};
+
+	for (usize i = 0; i < TARRAY_SIZE(streams); ++i) {
+		ScopeEntry *entry =
+		    scope_lookup(vm->assembly->gscope, mir_get_builtin_id(streams[i]), false, false);
+		if (!entry || entry->kind != SCOPE_ENTRY_VAR) continue;
+
+		MirVar * var  = entry->data.var;
+		MirType *type = var->value.type;
+		if (!var->rel_stack_ptr || var->value.is_comptime) continue;
+		if (!type || type->kind != MIR_TYPE_STRUCT) continue;
+
+		MirMember *fd   = find_stream_member(type, "fd");
+		MirMember *buf  = find_stream_member(type, "buf");
+		MirMember *len  = find_stream_member(type, "len");
+		MirMember *lock = find_stream_member(type, "lock");
+		if (!fd || !buf || !len || !lock) continue;
+
+		VMStackPtr stream = vm_read_var(vm, var);
+		memset(stream + lock->offset_bytes, 0, lock->type->store_size_bytes);
+
+		/* Executed code does not exit through __os_start, pending output of streams which
+		 * are not line buffered would never be written otherwise. */
+		const s64 pending = (s64)vm_read_int(len->type, stream + len->offset_bytes);
+		if (pending <= 0) continue;
+
+		MirType *  ptr_type = mir_get_struct_elem_type(buf->type, MIR_SLICE_PTR_INDEX);
+		VMStackPtr ptr      = vm_get_struct_elem_ptr(
+		    vm->assembly, buf->type, stream + buf->offset_bytes, MIR_SLICE_PTR_INDEX);
+		const char *data = (const char *)vm_read_ptr(ptr_type, ptr);
+
+		FILE *out = vm_read_int(fd->type, stream + fd->offset_bytes) == 2 ? stderr : stdout;
+		if (data) {
+			fwrite(data, 1, (size_t)pending, out);
+			fflush(out);
+		}
+
+		vm_write_int(len->type, stream + len->offset_bytes, 0);
+	}
+}
+
 bool
 _execute_fn_top_level(VM *                        vm,
                       MirFn *                     fn,
@@ -1422,7 +1889,7 @@ _execute_fn_top_level(VM *                        vm,
 	push_ra(vm, call);
 
 	/* allocate local variables */
-	stack_alloc_local_vars(vm, fn);
+	stack_alloc_frame(vm, fn);
 
 	/* setup entry instruction */
 	set_pc(vm, fn->first_block->entry_instr);
@@ -1434,12 +1901,18 @@ _execute_fn_top_level(VM *                        vm,
 		prev  = instr;
 		if (!instr || vm->stack->aborted) break;
 
+		if (check_limits(vm, instr)) {
+			exec_abort(vm, 10);
+			break;
+		}
+
 		interp_instr(vm, instr);
 
 		/* stack head can be changed by br instructions */
 		if (!get_pc(vm) || get_pc(vm) == prev) set_pc(vm, instr->next);
 	}
 
+	flush_print_streams(vm);
 	if (vm->stack->aborted) return false;
 
 	if (pop_return_value) {
@@ -1563,7 +2036,7 @@ interp_instr_toany(VM *vm, MirInstrToAny *toany)
 	MirType *data_type = toany->expr->value.type;
 
 	if (toany->expr_tmp) {
-		VMStackPtr data      = fetch_value(vm, &toany->expr->value);
+		VMStackPtr data      = fetch_value(vm, toany->expr);
 		MirVar *   expr_var  = toany->expr_tmp;
 		VMStackPtr dest_expr = vm_read_var(vm, expr_var);
 
@@ -1578,12 +2051,12 @@ interp_instr_toany(VM *vm, MirInstrToAny *toany)
 		/* setup destination pointer */
 		memcpy(dest_data, &rtti_data, dest_data_type->store_size_bytes);
 	} else {
-		VMStackPtr data = fetch_value(vm, &toany->expr->value);
+		VMStackPtr data = fetch_value(vm, toany->expr);
 		BL_ASSERT(mir_is_pointer_type(dest_data_type));
 		memcpy(dest_data, data, dest_data_type->store_size_bytes);
 	}
 
-	stack_push(vm, &dest, toany->base.value.type);
+	push_result(vm, &toany->base, &dest);
 }
 
 void
@@ -1615,8 +2088,8 @@ interp_instr_phi(VM *vm, MirInstrPhi *phi)
 		MirType *phi_type = phi->base.value.type;
 		BL_ASSERT(phi_type);
 
-		VMStackPtr value_ptr = fetch_value(vm, &value->value);
-		stack_push(vm, value_ptr, phi_type);
+		VMStackPtr value_ptr = fetch_value(vm, value);
+		push_result(vm, &phi->base, value_ptr);
 	}
 }
 
@@ -1628,14 +2101,15 @@ interp_instr_addrof(VM *vm, MirInstrAddrOf *addrof)
 	BL_ASSERT(type);
 
 	if (src->kind == MIR_INSTR_ELEM_PTR || src->kind == MIR_INSTR_COMPOUND) {
-		/* address of the element is already on the stack */
+		/* address of the element is already on the stack or in the source slot */
+		if (addrof->base.vm_slot) push_result(vm, &addrof->base, fetch_value(vm, src));
 		return;
 	}
 
-	VMStackPtr ptr = fetch_value(vm, &src->value);
+	VMStackPtr ptr = fetch_value(vm, src);
 	ptr            = VM_STACK_PTR_DEREF(ptr);
 
-	stack_push(vm, (VMStackPtr)&ptr, type);
+	push_result(vm, &addrof->base, (VMStackPtr)&ptr);
 }
 
 void
@@ -1643,8 +2117,8 @@ interp_instr_elem_ptr(VM *vm, MirInstrElemPtr *elem_ptr)
 {
 	/* pop index from stack */
 	MirType *  arr_type   = mir_deref_type(elem_ptr->arr_ptr->value.type);
-	VMStackPtr index_ptr  = fetch_value(vm, &elem_ptr->index->value);
-	VMStackPtr arr_ptr    = fetch_value(vm, &elem_ptr->arr_ptr->value);
+	VMStackPtr index_ptr  = fetch_value(vm, elem_ptr->index);
+	VMStackPtr arr_ptr    = fetch_value(vm, elem_ptr->arr_ptr);
 	VMStackPtr result_ptr = NULL;
 	BL_ASSERT(arr_ptr && index_ptr);
 
@@ -1656,12 +2130,13 @@ interp_instr_elem_ptr(VM *vm, MirInstrElemPtr *elem_ptr)
 	case MIR_TYPE_ARRAY: {
 		const s64 len = arr_type->data.array.len;
 		if (index >= len) {
-			msg_error("Array index is out of the bounds! Array index "
-			          "is: %lli, "
-			          "but array size "
-			          "is: %lli",
-			          (long long)index,
-			          (long long)len);
+			VM_ERROR(vm,
+			         "Array index is out of the bounds! Array index "
+			         "is: %lli, "
+			         "but array size "
+			         "is: %lli",
+			         (long long)index,
+			         (long long)len);
 			exec_abort(vm, 0);
 		}
 
@@ -1685,15 +2160,16 @@ interp_instr_elem_ptr(VM *vm, MirInstrElemPtr *elem_ptr)
 		const s64  len_tmp = vm_read_int(len_type, len_ptr);
 
 		if (!ptr_tmp) {
-			msg_error("Dereferencing null pointer! Slice has not been set?");
+			VM_ERROR(vm, "Dereferencing null pointer! Slice has not been set?");
 			exec_abort(vm, 0);
 		}
 
 		if (index >= len_tmp) {
-			msg_error("Array index is out of the bounds! Array index is: %lli, but "
-			          "array size is: %lli",
-			          (long long)index,
-			          (long long)len_tmp);
+			VM_ERROR(vm,
+			         "Array index is out of the bounds! Array index is: %lli, but "
+			         "array size is: %lli",
+			         (long long)index,
+			         (long long)len_tmp);
 			exec_abort(vm, 0);
 		}
 
@@ -1706,7 +2182,7 @@ interp_instr_elem_ptr(VM *vm, MirInstrElemPtr *elem_ptr)
 	}
 
 	/* push result address on the stack */
-	stack_push(vm, (VMStackPtr)&result_ptr, elem_ptr->base.value.type);
+	push_result(vm, &elem_ptr->base, (VMStackPtr)&result_ptr);
 }
 
 void
@@ -1724,7 +2200,7 @@ interp_instr_member_ptr(VM *vm, MirInstrMemberPtr *member_ptr)
 	BL_ASSERT(mir_is_composit_type(target_type) && "expected structure");
 
 	/* fetch address of the struct begin */
-	VMStackPtr ptr = fetch_value(vm, &member_ptr->target_ptr->value);
+	VMStackPtr ptr = fetch_value(vm, member_ptr->target_ptr);
 	ptr            = VM_STACK_PTR_DEREF(ptr);
 	BL_ASSERT(ptr);
 
@@ -1753,13 +2229,13 @@ interp_instr_member_ptr(VM *vm, MirInstrMemberPtr *member_ptr)
 	}
 
 	/* push result address on the stack */
-	stack_push(vm, (VMStackPtr)&result, member_ptr->base.value.type);
+	push_result(vm, &member_ptr->base, (VMStackPtr)&result);
 }
 
 void
 interp_instr_unreachable(VM *vm, MirInstrUnreachable *unr)
 {
-	msg_error("execution reached unreachable code");
+	VM_ERROR(vm, "execution reached unreachable code");
 	exec_abort(vm, 0);
 }
 
@@ -1775,7 +2251,7 @@ void
 interp_instr_switch(VM *vm, MirInstrSwitch *sw)
 {
 	MirType *  value_type = sw->value->value.type;
-	VMStackPtr value_ptr  = fetch_value(vm, &sw->value->value);
+	VMStackPtr value_ptr  = fetch_value(vm, sw->value);
 	BL_ASSERT(value_ptr);
 
 	const s64 value       = vm_read_int(value_type, value_ptr);
@@ -1800,11 +2276,11 @@ interp_instr_cast(VM *vm, MirInstrCast *cast)
 {
 	MirType *  dest_type = cast->base.value.type;
 	MirType *  src_type  = cast->expr->value.type;
-	VMStackPtr src_ptr   = fetch_value(vm, &cast->expr->value);
+	VMStackPtr src_ptr   = fetch_value(vm, cast->expr);
 
 	VMValue tmp = {0};
 	do_cast((VMStackPtr)&tmp, src_ptr, dest_type, src_type, cast->op);
-	stack_push(vm, &tmp, dest_type);
+	push_result(vm, &cast->base, &tmp);
 }
 
 void
@@ -1821,8 +2297,10 @@ interp_instr_arg(VM *vm, MirInstrArg *arg)
 		MirInstr *curr_arg_value = arg_values->data[arg->i];
 
 		if (mir_is_comptime(curr_arg_value)) {
-			MirType *type = curr_arg_value->value.type;
-			stack_push(vm, curr_arg_value->value.data, type);
+			push_result(vm, &arg->base, curr_arg_value->value.data);
+		} else if (curr_arg_value->vm_slot) {
+			/* Argument value is located in the caller frame slot. */
+			push_result(vm, &arg->base, frame_slot_ptr(get_ra(vm)->prev, curr_arg_value));
 		} else {
 			/* Arguments are located in reverse order right before return address on the
 			 * stack
@@ -1838,7 +2316,7 @@ interp_instr_arg(VM *vm, MirInstrArg *arg)
 				    stack_alloc_size(arg_value->value.type->store_size_bytes);
 			}
 
-			stack_push(vm, (VMStackPtr)arg_ptr, arg->base.value.type);
+			push_result(vm, &arg->base, (VMStackPtr)arg_ptr);
 		}
 
 		return;
@@ -1858,7 +2336,7 @@ interp_instr_arg(VM *vm, MirInstrArg *arg)
 		arg_ptr -= stack_alloc_size(args->data[i]->type->store_size_bytes);
 	}
 
-	stack_push(vm, (VMStackPtr)arg_ptr, arg->base.value.type);
+	push_result(vm, &arg->base, (VMStackPtr)arg_ptr);
 }
 
 void
@@ -1868,7 +2346,7 @@ interp_instr_cond_br(VM *vm, MirInstrCondBr *br)
 	MirType *type = br->cond->value.type;
 
 	/* pop condition from stack */
-	VMStackPtr cond_ptr = fetch_value(vm, &br->cond->value);
+	VMStackPtr cond_ptr = fetch_value(vm, br->cond);
 	BL_ASSERT(cond_ptr);
 
 	const bool condition = vm_read_int(type, cond_ptr);
@@ -1894,7 +2372,7 @@ interp_instr_decl_ref(VM *vm, MirInstrDeclRef *ref)
 		BL_ASSERT(var);
 
 		VMStackPtr real_ptr = vm_read_var(vm, var);
-		stack_push(vm, &real_ptr, ref->base.value.type);
+		push_result(vm, &ref->base, &real_ptr);
 		break;
 	}
 
@@ -1917,7 +2395,7 @@ interp_instr_decl_direct_ref(VM *vm, MirInstrDeclDirectRef *ref)
 	BL_ASSERT(var);
 
 	VMStackPtr real_ptr = vm_read_var(vm, var);
-	stack_push(vm, &real_ptr, ref->base.value.type);
+	push_result(vm, &ref->base, &real_ptr);
 }
 
 void
@@ -1961,12 +2439,12 @@ interp_instr_compound(VM *vm, VMStackPtr tmp_ptr, MirInstrCompound *cmp)
 		if (value->kind == MIR_INSTR_COMPOUND) {
 			interp_instr_compound(vm, elem_ptr, (MirInstrCompound *)value);
 		} else {
-			VMStackPtr value_ptr = fetch_value(vm, &value->value);
+			VMStackPtr value_ptr = fetch_value(vm, value);
 			memcpy(elem_ptr, value_ptr, elem_type->store_size_bytes);
 		}
 	}
 
-	if (will_push) stack_push(vm, tmp_ptr, cmp->base.value.type);
+	if (will_push) push_result(vm, &cmp->base, tmp_ptr);
 }
 
 void
@@ -1991,7 +2469,7 @@ interp_instr_vargs(VM *vm, MirInstrVArgs *vargs)
 			const usize value_size = value->value.type->store_size_bytes;
 			VMStackPtr  dest       = arr_tmp_ptr + i * value_size;
 
-			value_ptr = fetch_value(vm, &value->value);
+			value_ptr = fetch_value(vm, value);
 			memcpy(dest, value_ptr, value_size);
 		}
 	}
@@ -2015,7 +2493,7 @@ interp_instr_vargs(VM *vm, MirInstrVArgs *vargs)
 
 		vm_write_as(VMStackPtr, ptr_ptr, arr_tmp_ptr);
 
-		stack_push(vm, vargs_tmp_ptr, vargs_tmp->value.type);
+		push_result(vm, &vargs->base, vargs_tmp_ptr);
 	}
 }
 
@@ -2037,7 +2515,7 @@ interp_instr_decl_var(VM *vm, MirInstrDeclVar *decl)
 			interp_instr_compound(vm, var_ptr, (MirInstrCompound *)decl->init);
 		} else {
 			/* read initialization value if there is one */
-			VMStackPtr init_ptr = fetch_value(vm, &decl->init->value);
+			VMStackPtr init_ptr = fetch_value(vm, decl->init);
 			memcpy(var_ptr, init_ptr, var->value.type->store_size_bytes);
 		}
 	}
@@ -2052,15 +2530,15 @@ interp_instr_load(VM *vm, MirInstrLoad *load)
 	BL_ASSERT(dest_type);
 	BL_ASSERT(mir_is_pointer_type(load->src->value.type));
 
-	VMStackPtr src_ptr = fetch_value(vm, &load->src->value);
+	VMStackPtr src_ptr = fetch_value(vm, load->src);
 	src_ptr            = VM_STACK_PTR_DEREF(src_ptr);
 
 	if (!src_ptr) {
-		msg_error("Dereferencing null pointer!");
+		VM_ERROR(vm, "Dereferencing null pointer!");
 		exec_abort(vm, 0);
 	}
 
-	stack_push(vm, src_ptr, dest_type);
+	push_result(vm, &load->base, src_ptr);
 }
 
 void
@@ -2072,8 +2550,8 @@ interp_instr_store(VM *vm, MirInstrStore *store)
 	MirType *src_type = store->src->value.type;
 	BL_ASSERT(src_type);
 
-	VMStackPtr dest_ptr = fetch_value(vm, &store->dest->value);
-	VMStackPtr src_ptr  = fetch_value(vm, &store->src->value);
+	VMStackPtr dest_ptr = fetch_value(vm, store->dest);
+	VMStackPtr src_ptr  = fetch_value(vm, store->src);
 
 	dest_ptr = VM_STACK_PTR_DEREF(dest_ptr);
 
@@ -2087,7 +2565,7 @@ interp_instr_call(VM *vm, MirInstrCall *call)
 	BL_ASSERT(call->callee && call->base.value.type);
 	BL_ASSERT(call->callee->value.type);
 
-	VMStackPtr callee_ptr      = fetch_value(vm, &call->callee->value);
+	VMStackPtr callee_ptr      = fetch_value(vm, call->callee);
 	MirType *  callee_ptr_type = call->callee->value.type;
 
 	/* Function called via pointer. */
@@ -2097,7 +2575,7 @@ interp_instr_call(VM *vm, MirInstrCall *call)
 
 	MirFn *callee = (MirFn *)vm_read_ptr(callee_ptr_type, callee_ptr);
 	if (callee == NULL) {
-		msg_error("Function pointer not set!");
+		VM_ERROR(vm, "Function pointer not set!");
 		exec_abort(vm, 0);
 		return;
 	}
@@ -2106,12 +2584,14 @@ interp_instr_call(VM *vm, MirInstrCall *call)
 
 	if (IS_FLAG(callee->flags, FLAG_EXTERN)) {
 		interp_extern_call(vm, callee, call);
+	} else if (IS_FLAG(callee->flags, FLAG_INTRINSIC)) {
+		interp_intrinsic_call(vm, callee, call);
 	} else {
 		/* Push current frame stack top. (Later poped by ret instruction)*/
 		push_ra(vm, &call->base);
 		BL_ASSERT(callee->first_block->entry_instr);
 
-		stack_alloc_local_vars(vm, callee);
+		stack_alloc_frame(vm, callee);
 
 		/* setup entry instruction */
 		set_pc(vm, callee->first_block->entry_instr);
@@ -2131,12 +2611,23 @@ interp_instr_ret(VM *vm, MirInstrRet *ret)
 
 	/* pop return value from stack */
 	if (ret->value) {
-		ret_data_ptr = fetch_value(vm, &ret->value->value);
+		ret_data_ptr = fetch_value(vm, ret->value);
 		BL_ASSERT(ret_data_ptr);
 
 		if (caller ? caller->base.ref_count == 1 : false) ret_data_ptr = NULL;
 	}
 
+	const bool is_caller_slot = caller ? caller->base.vm_slot : false;
+	if (ret_data_ptr && ret->value->vm_slot && !is_caller_slot) {
+		/* Return value is located in the callee frame slot, but it's going to be pushed on
+		 * the stack at the beginning of the released frame; both locations can overlap, so
+		 * we use temporary copy. */
+		const usize size = ret_type->store_size_bytes;
+		tsa_resize_Char(&vm->ret_tmp, size);
+		memcpy(vm->ret_tmp.data, ret_data_ptr, size);
+		ret_data_ptr = (VMStackPtr)vm->ret_tmp.data;
+	}
+
 	/* do frame stack rollback */
 	MirInstr *pc = (MirInstr *)pop_ra(vm);
 
@@ -2147,7 +2638,8 @@ interp_instr_ret(VM *vm, MirInstrRet *ret)
 			MirInstr *arg_value;
 			TSA_FOREACH(arg_values, arg_value)
 			{
-				if (mir_is_comptime(arg_value)) continue;
+				/* Values stored in frame slots are not pushed on the stack. */
+				if (mir_is_comptime(arg_value) || arg_value->vm_slot) continue;
 				stack_pop(vm, arg_value->value.type);
 			}
 		}
@@ -2173,6 +2665,8 @@ interp_instr_ret(VM *vm, MirInstrRet *ret)
 		const bool is_caller_comptime = caller ? caller->base.value.is_comptime : false;
 		if (is_caller_comptime) {
 			caller->base.value.data = ret->value->value.data;
+		} else if (is_caller_slot) {
+			push_result(vm, &caller->base, ret_data_ptr);
 		} else {
 			stack_push(vm, ret_data_ptr, ret_type);
 		}
@@ -2189,8 +2683,8 @@ interp_instr_binop(VM *vm, MirInstrBinop *binop)
 	/* binop expects lhs and rhs on stack in exact order and push result again
 	 * to the stack */
 
-	VMStackPtr lhs_ptr = fetch_value(vm, &binop->lhs->value);
-	VMStackPtr rhs_ptr = fetch_value(vm, &binop->rhs->value);
+	VMStackPtr lhs_ptr = fetch_value(vm, binop->lhs);
+	VMStackPtr rhs_ptr = fetch_value(vm, binop->rhs);
 	BL_ASSERT(rhs_ptr && lhs_ptr);
 
 	MirType *dest_type = binop->base.value.type;
@@ -2199,19 +2693,19 @@ interp_instr_binop(VM *vm, MirInstrBinop *binop)
 	VMValue tmp = {0};
 	calculate_binop(dest_type, src_type, (VMStackPtr)&tmp, lhs_ptr, rhs_ptr, binop->op);
 
-	stack_push(vm, &tmp, dest_type);
+	push_result(vm, &binop->base, &tmp);
 }
 
 void
 interp_instr_unop(VM *vm, MirInstrUnop *unop)
 {
 	MirType *  type  = unop->base.value.type;
-	VMStackPtr v_ptr = fetch_value(vm, &unop->expr->value);
+	VMStackPtr v_ptr = fetch_value(vm, unop->expr);
 
 	VMValue tmp = {0};
 	calculate_unop((VMStackPtr)&tmp, v_ptr, unop->op, type);
 
-	stack_push(vm, &tmp, type);
+	push_result(vm, &unop->base, &tmp);
 }
 
 void
@@ -2596,12 +3090,22 @@ vm_init(VM *vm, usize stack_size)
 	vm->stack = stack;
 
 	tsa_init(&vm->dyncall_sig_tmp);
+	tsa_init(&vm->ret_tmp);
+	thtbl_init(&vm->dyncall_sig_cache, sizeof(char *), 64);
 }
 
 void
 vm_terminate(VM *vm)
 {
+	TIterator it;
+	THTBL_FOREACH(&vm->dyncall_sig_cache, it)
+	{
+		bl_free(thtbl_iter_peek_value(char *, it));
+	}
+
+	thtbl_terminate(&vm->dyncall_sig_cache);
 	tsa_terminate(&vm->dyncall_sig_tmp);
+	tsa_terminate(&vm->ret_tmp);
 	bl_free(vm->stack);
 }
 
@@ -2626,6 +3130,7 @@ vm_execute_fn(VM *vm, Assembly *assembly, MirFn *fn, VMStackPtr *out_ptr)
 {
 	vm->assembly       = assembly;
 	vm->stack->aborted = false;
+	reset_limits(vm);
 	return execute_fn_impl_top_level(vm, fn, NULL, out_ptr);
 }
 
@@ -2638,9 +3143,155 @@ vm_execute_instr_top_level_call(VM *vm, Assembly *assembly, MirInstrCall *call)
 	assert(call->base.value.is_comptime && "Top level call is expected to be comptime.");
 	if (call->args) BL_ABORT("exec call top level has not implemented passing of arguments");
 
+	reset_limits(vm);
 	return execute_fn_top_level(vm, &call->base, NULL);
 }
 
+void
+vm_pool_init(VMPool *pool, usize thread_count, usize stack_size)
+{
+	BL_ASSERT(thread_count > 0);
+
+	pool->vmc = thread_count;
+	pool->vms = bl_malloc(sizeof(VM) * thread_count);
+	if (!pool->vms) BL_ABORT("bad alloc");
+
+	for (usize i = 0; i < thread_count; ++i) {
+		memset(&pool->vms[i], 0, sizeof(VM));
+		vm_init(&pool->vms[i], stack_size);
+		pool->vms[i].quiet = true;
+	}
+
+	thtbl_init(&pool->jobs, sizeof(VMPoolJob *), 256);
+	tarray_init(&pool->pending, sizeof(VMPoolJob *));
+	pool->mutex    = thread_mutex_new();
+	pool->next_job = 0;
+	pool->next_vm  = 0;
+}
+
+void
+vm_pool_terminate(VMPool *pool)
+{
+	TIterator it;
+	THTBL_FOREACH(&pool->jobs, it)
+	{
+		VMPoolJob *job = thtbl_iter_peek_value(VMPoolJob *, it);
+		bl_free(job->result);
+		bl_free(job);
+	}
+
+	for (usize i = 0; i < pool->vmc; ++i) {
+		vm_terminate(&pool->vms[i]);
+	}
+
+	bl_free(pool->vms);
+	thtbl_terminate(&pool->jobs);
+	tarray_terminate(&pool->pending);
+	thread_mutex_delete(pool->mutex);
+}
+
+bool
+vm_pool_can_execute(VMPool *pool, MirInstrCall *call)
+{
+	BL_ASSERT(call && call->base.analyzed);
+
+	/* Worker threads cannot compute frame layouts or allocate local variables, so the pool
+	 * can be used only when all layouts are computed in advance. */
+	if (!builder.options.vm_frame_slots) return false;
+	if (call->args || !mir_is_comptime(call->callee)) return false;
+	if (call->callee->value.type->kind != MIR_TYPE_FN) return false;
+
+	MirFn *             fn   = get_callee(call);
+	TSmallArray_ArgPtr *args = fn->type->data.fn.args;
+	if (args && args->size) return false;
+	if (!call->base.value.type || call->base.value.type->store_size_bytes == 0) return false;
+	if (IS_FLAG(fn->flags, FLAG_EXTERN) || IS_FLAG(fn->flags, FLAG_INTRINSIC)) return false;
+
+	TSmallArray_FnPtr visited;
+	tsa_init(&visited);
+	const bool result = pool_can_execute_fn(fn, &visited);
+	tsa_terminate(&visited);
+	return result;
+}
+
+void
+vm_pool_submit(VMPool *pool, Assembly *assembly, MirInstrCall *call)
+{
+	BL_ASSERT(!thtbl_has_key(&pool->jobs, (u64)call) && "Call already submitted!");
+
+	VMPoolJob *job = bl_malloc(sizeof(VMPoolJob));
+	if (!job) BL_ABORT("bad alloc");
+
+	job->call        = call;
+	job->assembly    = assembly;
+	job->result      = bl_malloc(call->base.value.type->store_size_bytes);
+	job->state       = VM_POOL_JOB_PENDING;
+	job->start_time  = 0;
+	job->is_commited = false;
+	if (!job->result) BL_ABORT("bad alloc");
+
+	thtbl_insert(&pool->jobs, (u64)call, job);
+	tarray_push(&pool->pending, job);
+}
+
+bool
+vm_pool_is_pending(VMPool *pool)
+{
+	return pool->pending.size > 0;
+}
+
+void
+vm_pool_flush(VMPool *pool)
+{
+	if (!vm_pool_is_pending(pool)) return;
+	BL_ASSERT(!flushed_pool && "Pool flush cannot be nested!");
+
+	const usize threadc = pool->vmc < pool->pending.size ? pool->vmc : pool->pending.size;
+	Thread *    threads = bl_malloc(sizeof(Thread) * threadc);
+	if (!threads) BL_ABORT("bad alloc");
+
+	flushed_pool   = pool;
+	pool->next_job = 0;
+	pool->next_vm  = 0;
+
+	for (usize i = 0; i < threadc; ++i) {
+		threads[i] = thread_new(&pool_worker);
+	}
+
+	for (usize i = 0; i < threadc; ++i) {
+		thread_join(threads[i]);
+		thread_delete(threads[i]);
+	}
+
+	flushed_pool = NULL;
+	tarray_clear(&pool->pending);
+	bl_free(threads);
+}
+
+VMPoolJobState
+vm_pool_commit(VMPool *pool, VM *vm, MirInstrCall *call)
+{
+	TIterator it = thtbl_find(&pool->jobs, (u64)call);
+	if (TITERATOR_EQUAL(it, thtbl_end(&pool->jobs))) return VM_POOL_JOB_NONE;
+
+	VMPoolJob *job = thtbl_iter_peek_value(VMPoolJob *, it);
+	if (job->state == VM_POOL_JOB_FAILED) vm->resume_time = job->start_time;
+	if (job->state != VM_POOL_JOB_PASSED || job->is_commited) return job->state;
+
+	/* Result is copied into memory owned by the main VM since all worker stacks are reused
+	 * by the next flush. */
+	MirConstExprValue *value = &call->base.value;
+	if (needs_tmp_alloc(value)) {
+		value->data = stack_push_empty(vm, value->type);
+	} else {
+		value->data = (VMStackPtr)&value->_tmp;
+	}
+
+	memcpy(value->data, job->result, value->type->store_size_bytes);
+	job->is_commited = true;
+	return VM_POOL_JOB_PASSED;
+}
+
 VMStackPtr
 vm_alloc_global(VM *vm, Assembly *assembly, MirVar *var)
 {
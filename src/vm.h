@@ -30,6 +30,8 @@
 #define BL_VM_H
 
 #include "common.h"
+#include "threading.h"
+#include <time.h>
 
 /* Stack data manipulation helper macros. */
 #define VM_STACK_PTR_DEREF(ptr) ((VMStackPtr) * ((uintptr_t *)(ptr)))
@@ -67,9 +69,37 @@ typedef struct VM {
 	VMStack *        stack;
 	struct Assembly *assembly;
 	TSmallArray_Char dyncall_sig_tmp;
+	THashTable       dyncall_sig_cache; /* generated signatures (char *) hashed by type ID */
+	TSmallArray_Char ret_tmp; /* temporary copy of return value (used with frame slots) */
 	bool             aborted;
+	bool             quiet; /* do not report execution errors (used by pool workers) */
+
+	/* Execution limits, counters are reset by every top-level execution. */
+	u64    steps;       /* count of executed instructions */
+	time_t start_time;  /* wall-clock time when execution started */
+	time_t resume_time; /* start time of failed pool job executed again, zero when not set */
 } VM;
 
+typedef enum VMPoolJobState {
+	VM_POOL_JOB_NONE,    /* call was not submitted into the pool */
+	VM_POOL_JOB_PENDING, /* call is waiting for the next flush */
+	VM_POOL_JOB_PASSED,  /* result was commited into the call value */
+	VM_POOL_JOB_FAILED,  /* execution failed */
+} VMPoolJobState;
+
+/* Pool of worker VM instances used for parallel execution of independent compile time calls.
+ * Calls are collected by vm_pool_submit and executed all at once by vm_pool_flush; caller thread
+ * is blocked until all jobs are done, so MIR cannot be changed during execution. */
+typedef struct VMPool {
+	VM *       vms;
+	usize      vmc;
+	THashTable jobs;    /* all submitted jobs (VMPoolJob *) hashed by call instruction */
+	TArray     pending; /* jobs waiting for flush (VMPoolJob *) */
+	Mutex      mutex;
+	usize      next_job;
+	usize      next_vm;
+} VMPool;
+
 void
 vm_init(VM *vm, usize stack_size);
 
@@ -97,6 +127,38 @@ vm_execute_fn(VM *vm, struct Assembly *assembly, struct MirFn *fn, VMStackPtr *o
 VMStackPtr
 vm_alloc_global(VM *vm, struct Assembly *assembly, struct MirVar *var);
 
+/* Create pool of thread_count quiet VMs, each with its own stack of stack_size bytes. */
+void
+vm_pool_init(VMPool *pool, usize thread_count, usize stack_size);
+
+/* Release all pool VMs and results of submitted jobs. */
+void
+vm_pool_terminate(VMPool *pool);
+
+/* Check whether call can be executed by the pool. Only calls without arguments to fully analyzed
+ * functions which don't call external or unknown functions and don't touch mutable global
+ * variables are accepted. */
+bool
+vm_pool_can_execute(VMPool *pool, struct MirInstrCall *call);
+
+/* Queue call for execution by the next vm_pool_flush, call can be submitted only once. */
+void
+vm_pool_submit(VMPool *pool, struct Assembly *assembly, struct MirInstrCall *call);
+
+/* Check whether there are submitted jobs waiting for flush. */
+bool
+vm_pool_is_pending(VMPool *pool);
+
+/* Execute all pending jobs in parallel and wait for them. */
+void
+vm_pool_flush(VMPool *pool);
+
+/* Commit result of pool execution into the call value. Failed jobs are supposed to be executed
+ * again on the main VM to produce diagnostics, the next execution on vm continues with time
+ * already spent by the failed job, so timeout is not restarted. */
+VMPoolJobState
+vm_pool_commit(VMPool *pool, VM *vm, struct MirInstrCall *call);
+
 VMStackPtr
 vm_alloc_raw(VM *vm, struct Assembly *assembly, struct MirType *type);
 
@@ -6,6 +6,8 @@ echo "***********************"
 echo 
 blc -no-bin ../demos/vulkan_demo/src/vulkan_demo.bl 
 blc -no-bin ../demos/simple_sdl_game/src/skyshooter.bl 
+blc -no-bin bench/bench_print.bl
+blc -no-bin bench/bench_map.bl
 
 
 echo 
@@ -22,3 +24,52 @@ echo "*** Running test cases ***"
 echo "**************************"
 echo 
 blc -no-bin -force-test-to-llvm -run-tests -no-warning src/test_dummy.bl
+
+
+echo 
+echo "*******************************************"
+echo "*** Running test cases (VM frame slots) ***"
+echo "*******************************************"
+echo 
+blc -no-bin -run-tests -no-warning -vm-frame-slots-on src/test_dummy.bl
+blc -no-bin -run-tests -no-warning -vm-frame-slots-on -comptime-threads=4 src/test_dummy.bl
+
+
+echo 
+echo "***********************************"
+echo "*** Running native thread tests ***"
+echo "***********************************"
+echo 
+blc -no-warning bench/bench_jobs.bl || exit 1
+./bench_jobs || exit 1
+rm -f bench_jobs
+
+
+echo 
+echo "***********************************"
+echo "*** Running PGO instrumentation ***"
+echo "***********************************"
+echo 
+if grep -q LINKER_PGO_LIB "$(dirname "$(which blc)")/../etc/bl.conf"; then
+    blc -no-warning -pgo-gen bench/bench_map.bl || exit 1
+    rm -f bench_map.profraw
+    LLVM_PROFILE_FILE=bench_map.profraw ./bench_map || exit 1
+    if [ ! -s bench_map.profraw ]; then
+        echo "Instrumented executable did not write profile."
+        exit 1
+    fi
+    rm -f bench_map bench_map.profraw
+else
+    echo "LINKER_PGO_LIB is not configured, skipping."
+fi
+
+
+echo 
+echo "*********************************"
+echo "*** Running bitcode link test ***"
+echo "*********************************"
+echo 
+blc -no-warning -no-bin -emit-bc link/bc_lib.bl || exit 1
+blc -no-warning -link-bc=bc_lib.bc link/bc_main.bl || exit 1
+./bc_main || exit 1
+rm -f bc_lib.bc bc_main